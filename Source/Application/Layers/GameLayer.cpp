@@ -16,8 +16,11 @@
 // to become unbound during at the draw call. I spent 3 days trying to
 // debug the issue, but to no avail. So for now, it stays in here.
 
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <filesystem>
+#include <limits>
 #include "raylib.h"
 #include "raymath.h"
 #include "box2d/box2d.h"
@@ -26,8 +29,10 @@
 #include "../../Core/Event/EventCollider.h"
 #include "../../Core/Utility/Debug.h"
 #include "../../Core/Renderer/TilemapRenderer.h"
+#include "../../Core/Serialization/BinaryMap.h"
 #include "../../Core/Utility/Globals.h"
 #include "../../Core/Backend/LayerManager.h"
+#include "../../Core/Backend/Program.h"
 #include "../../Core/Event/EventDispatcher.h"
 #include "../../Core/Audio/AudioManager.h"
 #include "TextAlertLayer.h"
@@ -99,7 +104,28 @@ namespace RE::Application {
                         }
 
                         const auto* info = static_cast<Core::sensorInfo*>(b2Shape_GetUserData(e.visitorShape));
-                        disableEventCollider(m_map, info->id);
+                        if (m_worldStreamer) {
+                            m_worldStreamer->disableEventCollider(info->id);
+                        }
+                        else {
+                            disableEventCollider(m_map, info->id);
+                        }
+                    }
+                });
+
+            // Subscribe map exits. The level can't be swapped in from here, the sensor events being dispatched
+            // belong to the world that's about to be destroyed.
+            m_eventBus.get<Core::playerCollisionEvent>().subscribe(
+                Core::subId::PLAYER_MAP_EXIT_CONTACT,
+                [](const Core::playerCollisionEvent& e) {
+                    return e.info.type == Core::sensorType::MAP_EXIT;
+                },
+                [this](const Core::playerCollisionEvent& e) {
+                    if (e.contactBegan) {
+                        m_pendingExit = Core::findNearestMapExit(
+                            m_map,
+                            getPlayerCenterPx(),
+                            std::numeric_limits<float>::infinity());
                     }
                 });
         }
@@ -131,13 +157,16 @@ namespace RE::Application {
             (playerWorldPos.y - camTarget.y) * camZoom + camOffset.y
         };
 
+        // Beam offsets are in window pixels, the frame can be smaller than the window
+        const float outputScale = m_resolutionScaler ? m_resolutionScaler->getOutputScale() : 1.0f;
+
         // Adjust beam offset depending on which direction player is facing, invert beam Y movement
         const bool playerFacingRight = m_playerCharacter->getPlayerDirection() == Core::direction::RIGHT;
-        const Vector2 beamOffset = playerFacingRight ? Vector2{g_beamOffsetXRight, g_beamOffsetY} : Vector2{g_beamOffsetXLeft, g_beamOffsetY};
+        const Vector2 beamOffset = Vector2Scale(
+            playerFacingRight ? Vector2{g_beamOffsetXRight, g_beamOffsetY} : Vector2{g_beamOffsetXLeft, g_beamOffsetY},
+            1.0f / outputScale);
         m_beamPosition = Vector2Add(playerScreenPos, beamOffset);
-        m_beamPosition.y = static_cast<float>(GetScreenHeight()) - m_beamPosition.y;
-
-        SetShaderValue(m_fragShader, m_flashlightPosLoc, &m_beamPosition, SHADER_UNIFORM_VEC2);
+        m_beamPosition.y = m_viewSize.y - m_beamPosition.y;
 
         // Flip normals 180 deg if player is facing left
         const Vector2 playerXNormals = playerFacingRight ? Vector2{1.0f, 0.0f} : Vector2{-1.0f, 0.0f};
@@ -146,8 +175,10 @@ namespace RE::Application {
         static bool lastFacingRight = playerFacingRight;
 
         if (IsMouseButtonDown(MOUSE_BUTTON_LEFT)) {
-            const Vector2 mousePos = GetMousePosition();
-            const Vector2 shaderMousePos = { mousePos.x, static_cast<float>(GetScreenHeight()) - mousePos.y };
+            const Vector2 mousePos = m_resolutionScaler
+                ? m_resolutionScaler->toInternal(GetMousePosition())
+                : GetMousePosition();
+            const Vector2 shaderMousePos = { mousePos.x, m_viewSize.y - mousePos.y };
 
             // Calculate direction vector from beam to mouse and relative angle
             const Vector2 vecToMouse = Vector2Normalize(Vector2Subtract(shaderMousePos, m_beamPosition));
@@ -173,7 +204,12 @@ namespace RE::Application {
 
         m_beamAngle = beamDir;
         lastFacingRight = playerFacingRight;
-        SetShaderValue(m_fragShader, m_flashlightDirLoc, &m_beamAngle, SHADER_UNIFORM_VEC2);
+
+        // The beam was worked out in the shader's y up screen space, lights live in the world
+        Core::lightSource& flashlight = m_lightManager->getLight(m_flashlight);
+        flashlight.position = Vector2Add(playerWorldPos, Vector2Scale(beamOffset, 1.0f / camZoom));
+        flashlight.direction = {m_beamAngle.x, -m_beamAngle.y};
+        flashlight.radius = g_flashlightRadius / (camZoom * outputScale);
     }
 
     void GameLayer::processSensorEvents() {
@@ -214,12 +250,62 @@ namespace RE::Application {
         }
     }
 
+    void GameLayer::finishMapLoad() {
+        m_map = m_mapLoader->takeMap();
+        m_mapLoader.reset();
+        m_camera = Core::SceneCamera(m_map, m_viewSize, m_cameraZoom);
+        m_camera.setTarget(*m_playerCharacter);
+        m_lightManager->setMapLights(m_map);
+
+        if (m_map.isStreamed) {
+            m_worldStreamer = std::make_unique<Core::WorldStreamer>(m_map, m_worldId);
+        }
+    }
+
+    void GameLayer::enterPendingExit() {
+        Core::preparedLevel level = m_levelTransition->takeLevel();
+        m_pendingExit = Core::g_noMapExit;
+
+        // The streamer owns bodies in the old world, and sensors free their info when destroyed
+        m_worldStreamer.reset();
+        Core::unloadMapPhysics(m_map);
+        Core::unloadMap(m_map);
+
+        const b2WorldId oldWorld = m_worldId;
+        m_map = std::move(level.map);
+        m_worldId = level.world;
+        m_worldStreamer = std::move(level.streamer);
+        m_playerCharacter->moveToWorld(m_worldId, Core::pixelsToMetersVec(level.spawnPx));
+        b2DestroyWorld(oldWorld);
+
+        m_camera = Core::SceneCamera(m_map, m_viewSize, m_cameraZoom);
+        m_camera.setTarget(*m_playerCharacter);
+        m_lightManager->setMapLights(m_map);
+
+        m_currentSave.currentMapPath = m_map.fullMapPath;
+        m_currentSave.centerPosition = m_playerCharacter->getPositionCenterMeters();
+        saveGame(m_currentSave);
+
+        #ifdef DEBUG
+            Core::logDbg("Entered map: ", m_map.fullMapPath.string());
+        #endif
+    }
+
+    [[nodiscard]] Vector2 GameLayer::getPlayerCenterPx() const {
+        return Core::metersToPixelsVec(m_playerCharacter->getPositionCenterMeters());
+    }
+
     void GameLayer::destroy() {
         #ifdef DEBUG
             logDbg("GameLayer destroyed at address: ", this);
         #endif
 
+        m_resolutionScaler.reset();
+        m_lightBuffer.reset();
+        m_lightManager.reset();
         UnloadShader(m_fragShader);
+        m_levelTransition.reset();
+        m_worldStreamer.reset();
         Core::unloadMap(m_map);
     }
 
@@ -229,33 +315,82 @@ namespace RE::Application {
         m_type = Core::layerType::PRIMARY_LAYER;
         m_isEnabled = true;
         m_worldDef.gravity = {0.0f, 50.0f};
+
+        Core::Program::getInstance().getScheduler().attachTo(m_worldDef);
+
         m_worldId = b2CreateWorld(&m_worldDef);
-        m_map = Core::loadMap(save.currentMapPath.string(), m_worldId);
+        m_textureAtlas = std::make_shared<Core::TextureAtlas>();
+        m_mapLoader = std::make_shared<Core::MapLoader>(save.currentMapPath, m_worldId, m_textureAtlas);
+        m_levelTransition = std::make_unique<Core::LevelTransition>(m_worldDef, m_textureAtlas);
         m_currentSave.currentMapPath = fs::path(save.currentMapPath);
         m_currentSave.centerPosition = save.centerPosition;
-        m_frameBuffer = LoadRenderTexture(GetScreenWidth(), GetScreenHeight());
-        m_camera = Core::SceneCamera(m_map, 1.5f);
-        m_fragShader = LoadShader(NULL, "../assets/Shaders/lighting.fsh"); // NOLINT
         m_beamAngle = Vector2{1.0f, 0.0f};
 
+        // With an internal resolution the camera draws one texel per world pixel, and the scaler does the zoom
+        if (g_useInternalResolution) {
+            m_resolutionScaler = std::make_unique<Core::ResolutionScaler>(
+                static_cast<int>(std::round(static_cast<float>(GetScreenWidth()) / g_cameraZoom)),
+                static_cast<int>(std::round(static_cast<float>(GetScreenHeight()) / g_cameraZoom)));
+
+            m_viewSize = m_resolutionScaler->getSize();
+            m_cameraZoom = 1.0f;
+
+            if (g_useDynamicResolution) {
+                m_dynamicResolution = std::make_unique<Core::DynamicResolution>(
+                    Core::Program::getInstance().getTargetFrameTime());
+            }
+        }
+        else {
+            m_viewSize = {static_cast<float>(GetScreenWidth()), static_cast<float>(GetScreenHeight())};
+            m_cameraZoom = g_cameraZoom;
+        }
+
+        m_frameBuffer = LoadRenderTexture(static_cast<int>(m_viewSize.x), static_cast<int>(m_viewSize.y));
+        m_fragShader = LoadShader(NULL, "../assets/Shaders/lighting.fsh"); // NOLINT
+
         if (!IsShaderValid(m_fragShader)) {
             Core::logFatal("Unable to load shader. GameLayer::GameLayer()");
             return;
         }
 
-        m_flashlightPosLoc = GetShaderLocation(m_fragShader, "lightPos");
-        m_flashlightDirLoc = GetShaderLocation(m_fragShader, "lightDirection");
         m_screenResLoc = GetShaderLocation(m_fragShader, "screenResolution");
 
-        const Vector2 screenRes = {static_cast<float>(GetScreenWidth()), static_cast<float>(GetScreenHeight())};
-
         SetShaderValue(
             m_fragShader,
             m_screenResLoc,
-            &screenRes,
+            &m_viewSize,
             SHADER_UNIFORM_VEC2);
 
         try {
+            m_lightManager = std::make_unique<Core::LightManager>(
+                m_fragShader,
+                static_cast<int>(m_viewSize.x),
+                static_cast<int>(m_viewSize.y));
+
+            if (g_lightingDownscale > 1) {
+                m_lightBuffer = std::make_unique<Core::LightBuffer>(
+                    static_cast<int>(m_viewSize.x),
+                    static_cast<int>(m_viewSize.y),
+                    g_lightingDownscale);
+
+                const int outputLightOnly = 1;
+                SetShaderValue(
+                    m_fragShader,
+                    GetShaderLocation(m_fragShader, "outputLightOnly"),
+                    &outputLightOnly,
+                    SHADER_UNIFORM_INT);
+            }
+
+            Core::lightSource flashlight{};
+            flashlight.type = Core::lightType::CONE;
+            flashlight.color = g_flashlightColor;
+            flashlight.radius = g_flashlightRadius;
+            flashlight.intensity = 1.0f;
+            flashlight.coneAngle = g_flashlightConeAngle;
+            flashlight.softness = g_flashlightSoftness;
+            flashlight.direction = {1.0f, 0.0f};
+            m_flashlight = m_lightManager->addLight(flashlight);
+
             m_audioManager = std::make_shared<Core::AudioManager>();
 
             m_audioManager->pushSound(
@@ -281,7 +416,8 @@ namespace RE::Application {
                 Core::metersToPixels(m_currentSave.centerPosition.x),
                 Core::metersToPixels(m_currentSave.centerPosition.y),
                 m_worldId,
-                m_audioManager);
+                m_audioManager,
+                m_textureAtlas);
         }
         catch (const std::bad_alloc& e) {
             Core::logFatal(std::string("GameLayer::GameLayer(Args...) failed: ") + std::string(e.what()));
@@ -294,7 +430,6 @@ namespace RE::Application {
 
         m_eventBus.addDispatcher(Core::EventDispatcher<Core::playerCollisionEvent>());
         this->setEventCallbacks();
-        m_camera.setTarget(*m_playerCharacter);
     }
 
     GameLayer::~GameLayer() {
@@ -305,44 +440,157 @@ namespace RE::Application {
         assert(m_playerCharacter);
         assert(b2World_IsValid(m_worldId));
 
+        // Nothing can move until the map exists, the world isn't stepped until then either
+        if (m_mapLoader) {
+            if (!m_mapLoader->update(g_mapLoadFrameBudget)) return;
+            finishMapLoad();
+        }
+
+        // Streamed maps stay frozen until the ground around the camera exists
+        if (m_worldStreamer) {
+            m_worldStreamer->update(m_camera.getCameraTarget(), g_streamFrameBudget);
+            if (!m_worldStreamer->isLoadedAround(m_camera.getCameraTarget())) return;
+        }
+
+        // The player reached an exit before its map was ready, so hold everything until it is
+        if (m_pendingExit != Core::g_noMapExit) {
+            m_levelTransition->update(m_map, getPlayerCenterPx(), g_mapLoadFrameBudget);
+            if (!m_levelTransition->isReadyFor(m_pendingExit)) return;
+
+            enterPendingExit();
+        }
+
         m_playerCharacter->pollEvents();
-        b2World_Step(m_worldId, g_worldStep, g_subStep);
-        this->processSensorEvents();
-        m_playerCharacter->update(m_worldId);
+
+        // The world only moves in whole g_worldSteps, so a slow frame runs several and a fast one may run none.
+        // Past g_maxWorldSteps the game slows down instead, or every step would make the next frame slower.
+        m_stepAccumulator = std::min(m_stepAccumulator + GetFrameTime(), g_worldStep * g_maxWorldSteps);
+
+        while (m_stepAccumulator >= g_worldStep) {
+            m_stepAccumulator -= g_worldStep;
+
+            b2World_Step(m_worldId, g_worldStep, g_subStep);
+            this->processSensorEvents();
+
+            if (m_pendingExit != Core::g_noMapExit && m_levelTransition->isReadyFor(m_pendingExit)) {
+                enterPendingExit();
+            }
+
+            m_playerCharacter->update(m_worldId);
+            if (m_playerCharacter->isDead()) break;
+        }
+
+        // Drawn somewhere between the last two steps, by how far the clock has got toward the next one
+        m_playerCharacter->interpolate(m_stepAccumulator / g_worldStep);
+
+        if (m_dynamicResolution) {
+            const Core::frameTiming& timing = Core::Program::getInstance().getLastFrameTiming();
+
+            if (m_dynamicResolution->addFrame(timing.cpuSeconds, timing.presentSeconds)) {
+                m_resolutionScaler->setRenderScale(m_dynamicResolution->getScale());
+            }
+        }
+
+        // Recreated cameras start at full scale, so this goes every frame
+        if (m_resolutionScaler) m_camera.setViewScale(m_resolutionScaler->getRenderScale());
         m_camera.update(*m_playerCharacter);
         m_audioManager->updateMusic();
+        m_levelTransition->update(m_map, getPlayerCenterPx(), g_mapPrefetchFrameBudget);
 
-        if (g_drawShaderEffects)
+        if (g_drawShaderEffects) {
             updateBeam();
+            m_lightManager->updateShadowGeometry(m_map, m_worldStreamer.get());
+            m_lightManager->update(m_camera, GetTime());
+        }
+
+        #ifdef DEBUG
+            // Compare .tmj and .rmap load times for the current map, results go to the log
+            if (IsKeyPressed(KEY_F5)) {
+                fs::path tiledMapPath = m_currentSave.currentMapPath;
+                tiledMapPath.replace_extension(".tmj");
+
+                Core::benchmarkMapLoad(tiledMapPath, 10);
+            }
+
+            // Step time of a stress scene against thread count, results go to the log
+            if (IsKeyPressed(KEY_F6)) Core::benchmarkPhysicsStep(4000, 300);
+        #endif
     }
 
     void GameLayer::draw() {
         assert(m_playerCharacter);
 
+        if (m_mapLoader) {
+            ClearBackground(BLACK);
+            Core::drawMapLoadProgress(*m_mapLoader, {600.0f, 420.0f, 300.0f, 20.0f});
+            return;
+        }
+
         if (!m_playerCharacter->isDead()) {
+            Core::TaskScheduler& scheduler = Core::Program::getInstance().getScheduler();
+
+            Core::resetTileRenderStats();
+            m_renderQueue.resetStats();
+            Core::updateTileCache(m_camera, m_map, {0.0f, 0.0f});
+
             BeginTextureMode(m_frameBuffer);
                 ClearBackground(BLACK);
                 m_camera.cameraBegin();
-                    Core::renderBackgroundLayers(m_camera, m_map, {0.0f, 0.0f}, WHITE);
+                    Core::renderBackgroundLayers(m_renderQueue, scheduler, m_camera, m_map, {0.0f, 0.0f}, WHITE);
+                    m_renderQueue.flush();
                 m_camera.cameraEnd();
             EndTextureMode();
 
-            // Single render pass for the shader.
-            if (g_drawShaderEffects) BeginShaderMode(m_fragShader);
-            DrawTextureRec(
-                m_frameBuffer.texture,
-                {
-                    0.0f,
-                    0.0f,
-                    static_cast<float>(m_frameBuffer.texture.width),
-                    static_cast<float>(-m_frameBuffer.texture.height)},
-                {0.0f, 0.0f},
-                WHITE);
-            if (g_drawShaderEffects) EndShaderMode();
+            // With dynamic resolution only the top left of the frame is drawn into
+            const Vector2 renderSize = m_resolutionScaler ? m_resolutionScaler->getRenderSize() : m_viewSize;
+            const Rectangle renderRect = {0.0f, 0.0f, renderSize.x, renderSize.y};
+            const Rectangle frameSource = m_resolutionScaler
+                ? m_resolutionScaler->getRenderSource()
+                : Rectangle{0.0f, 0.0f, m_viewSize.x, -m_viewSize.y};
+
+            const bool isLitAtLowRes = g_drawShaderEffects && m_lightBuffer;
+
+            // Light the scene at a lower resolution, upscaled over the full resolution scene below.
+            // Has to happen before the scaler's texture mode, raylib can't nest them.
+            if (isLitAtLowRes) {
+                m_lightBuffer->begin();
+                    BeginShaderMode(m_fragShader);
+                        m_lightManager->bindTextures(m_fragShader);
+                        const Rectangle lightRect = m_lightBuffer->getRect();
+                        DrawTexturePro(
+                            m_frameBuffer.texture,
+                            frameSource,
+                            {
+                                0.0f,
+                                0.0f,
+                                lightRect.width * renderSize.x / m_viewSize.x,
+                                lightRect.height * renderSize.y / m_viewSize.y},
+                            {0.0f, 0.0f},
+                            0.0f,
+                            WHITE);
+                    EndShaderMode();
+                m_lightBuffer->end();
+            }
+
+            if (m_resolutionScaler) m_resolutionScaler->begin();
+
+            if (isLitAtLowRes) {
+                m_lightBuffer->drawComposited(m_frameBuffer, frameSource, renderRect);
+            }
+            else {
+                // Single render pass for the shader.
+                if (g_drawShaderEffects) {
+                    BeginShaderMode(m_fragShader);
+                    m_lightManager->bindTextures(m_fragShader);
+                }
+                DrawTexturePro(m_frameBuffer.texture, frameSource, renderRect, {0.0f, 0.0f}, 0.0f, WHITE);
+                if (g_drawShaderEffects) EndShaderMode();
+            }
 
             m_camera.cameraBegin();
-                m_playerCharacter->draw();
-                Core::renderForegroundLayers(m_camera, m_map, {0.0f, 0.0f}, WHITE);
+                m_playerCharacter->draw(m_renderQueue);
+                Core::renderForegroundLayers(m_renderQueue, scheduler, m_camera, m_map, {0.0f, 0.0f}, WHITE);
+                m_renderQueue.flush();
 
                 // TODO: Make a debug layer
                 #ifdef DEBUG
@@ -353,9 +601,15 @@ namespace RE::Application {
                     Core::drawDebugCameraCrosshair(m_camera);
                     Core::drawDebugCameraRect(m_camera);
                     Core::drawDebugEventColliders(m_map);
+                    if (m_worldStreamer) Core::drawDebugStreamedRegions(*m_worldStreamer);
                 #endif
             m_camera.cameraEnd();
 
+            if (m_resolutionScaler) {
+                m_resolutionScaler->end();
+                m_resolutionScaler->draw();
+            }
+
             #ifdef DEBUG
                 // Draw these outside of camera context!
                 Core::drawControlsWindow();
@@ -363,7 +617,15 @@ namespace RE::Application {
                 Core::drawDebugPlayerPosition(*m_playerCharacter);
                 Core::drawDebugPlayerAnimId(m_playerCharacter->getCurrentAnimId());
                 Core::drawDebugPlayerAnimState(m_playerCharacter->getCurrentActionState());
+                Core::drawDebugTileRenderStats(m_renderQueue.getStats());
+                Core::drawDebugLightStats(*m_lightManager);
+                if (m_dynamicResolution) Core::drawDebugRenderScale(*m_dynamicResolution);
+                Core::drawDebugSchedulerStats(scheduler.sampleStats());
             #endif
         }
     }
+
+    [[nodiscard]] std::weak_ptr<Core::MapLoader> GameLayer::getMapLoader() const noexcept {
+        return m_mapLoader;
+    }
 }
@@ -23,6 +23,14 @@
 #include "../../Core/Camera/Camera.h"
 #include "../../Core/Entity/Player.h"
 #include "../../Core/Renderer/Tilemap.h"
+#include "../../Core/Renderer/MapLoader.h"
+#include "../../Core/Renderer/WorldStreamer.h"
+#include "../../Core/Renderer/LevelTransition.h"
+#include "../../Core/Renderer/LightManager.h"
+#include "../../Core/Renderer/LightBuffer.h"
+#include "../../Core/Renderer/ResolutionScaler.h"
+#include "../../Core/Renderer/DynamicResolution.h"
+#include "../../Core/Renderer/RenderQueue.h"
 #include "../../Core/Backend/Layer.h"
 #include "../../Core/Serialization/Save.h"
 #include "../../Core/Event/EventBus.h"
@@ -37,15 +45,30 @@ namespace RE::Application {
         RenderTexture2D m_frameBuffer{};
         Shader m_fragShader{};
         std::shared_ptr<Core::AudioManager> m_audioManager{};
+        std::shared_ptr<Core::TextureAtlas> m_textureAtlas{};
+        std::shared_ptr<Core::MapLoader> m_mapLoader{}; // Null once the map has finished loading
+        std::unique_ptr<Core::WorldStreamer> m_worldStreamer{}; // Streamed maps only
+        std::unique_ptr<Core::LevelTransition> m_levelTransition{};
+        std::unique_ptr<Core::LightManager> m_lightManager{};
+        std::unique_ptr<Core::LightBuffer> m_lightBuffer{}; // Null when lighting runs at full resolution
+        std::unique_ptr<Core::ResolutionScaler> m_resolutionScaler{}; // Null when drawing straight to the window
+        std::unique_ptr<Core::DynamicResolution> m_dynamicResolution{}; // Null with a fixed resolution
         std::shared_ptr<Core::Player> m_playerCharacter{};
+        Core::RenderQueue m_renderQueue{};
         b2WorldId m_worldId{};
-        int m_flashlightPosLoc{};
-        int m_flashlightDirLoc{};
+        std::size_t m_pendingExit{Core::g_noMapExit}; // Exit the player walked into, entered once its map is ready
+        std::size_t m_flashlight{};  // Light id in m_lightManager
         int m_screenResLoc{};
+        Vector2 m_viewSize{};   // Size of the frame the world is drawn into
+        float m_cameraZoom{};
+        float m_stepAccumulator{};  // Seconds of frame time not yet simulated, always under g_worldStep after update()
         Vector2 m_beamPosition{};
         Vector2 m_beamAngle{};
 
         void setEventCallbacks();
+        void finishMapLoad();
+        void enterPendingExit();
+        [[nodiscard]] Vector2 getPlayerCenterPx() const;
         void updateBeam();
         void processSensorEvents();
         void destroy() override;
@@ -61,6 +84,9 @@ namespace RE::Application {
         void update() override;
         void draw() override;
 
+        // Lets other layers drive and show the map load while this one is suspended
+        [[nodiscard]] std::weak_ptr<Core::MapLoader> getMapLoader() const noexcept;
+
     };
 }
 
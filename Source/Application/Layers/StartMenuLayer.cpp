@@ -15,9 +15,10 @@
 #include "GameLayer.h"
 #include "../../Core/Backend/Program.h"
 #include "../../Core/Backend/LayerManager.h"
+#include "../../Core/Utility/Globals.h"
 
 namespace RE::Application {
-    StartMenuLayer::StartMenuLayer() :
+    StartMenuLayer::StartMenuLayer(std::weak_ptr<Core::MapLoader> mapLoader) :
         m_startButton(
             600.0f,
             300.0f,
@@ -34,7 +35,8 @@ namespace RE::Application {
             "../assets/Fonts/Jo_wrote_a_lovesong.ttf",
             400.0f,
             NULL, // NOLINT
-            0))
+            0)),
+        m_mapLoader(std::move(mapLoader))
     {
         if (!IsFontValid(m_headerFont)) {
             Core::logFatal("Cannot load header font: StartMenuLayer::StartMenuLayer()");
@@ -74,6 +76,13 @@ namespace RE::Application {
     }
 
     void StartMenuLayer::update() {
+        // The game layer is suspended while the menu is up, so the menu keeps its map loading.
+        // Starting is held back until there's a map to start in.
+        if (const auto loader = m_mapLoader.lock(); loader && !loader->update(g_mapLoadFrameBudget)) {
+            m_quitButton.update();
+            return;
+        }
+
         m_startButton.update();
         m_quitButton.update();
     }
@@ -89,7 +98,13 @@ namespace RE::Application {
             3.0f,
             RED);
 
-        m_startButton.draw();
+        if (const auto loader = m_mapLoader.lock(); loader && loader->getStage() != Core::mapLoadStage::DONE) {
+            Core::drawMapLoadProgress(*loader, {600.0f, 320.0f, 300.0f, 20.0f});
+        }
+        else {
+            m_startButton.draw();
+        }
+
         m_quitButton.draw();
     }
 }
@@ -16,17 +16,20 @@
 #ifndef STARTMENU_H
 #define STARTMENU_H
 
+#include <memory>
 #include "raylib.h"
 #include "../../Core/Backend/Layer.h"
 #include "../../Core/UI/RectButton.h"
+#include "../../Core/Renderer/MapLoader.h"
 
 namespace RE::Application {
     class StartMenuLayer final : public Core::Layer {
         Core::RectButton m_startButton;
         Core::RectButton m_quitButton;
         Font m_headerFont{};
+        std::weak_ptr<Core::MapLoader> m_mapLoader{}; // Expired once the game layer has its map
     public:
-        StartMenuLayer();
+        explicit StartMenuLayer(std::weak_ptr<Core::MapLoader> mapLoader);
         ~StartMenuLayer() override;
 
         StartMenuLayer(const StartMenuLayer&) = delete;
@@ -15,6 +15,7 @@
 #include <iostream>
 #include "EntityAnimation.h"
 #include "../Audio/AudioManager.h"
+#include "../Renderer/RenderQueue.h"
 #include "../Utility/Logging.h"
 
 namespace RE::Core {
@@ -146,6 +147,16 @@ namespace RE::Core {
         return *this;
     }
 
+    void EntityAnimation::offsetFrames(const Vector2 origin) noexcept {
+        for (auto& frame : m_frameIndices) {
+            frame.x += origin.x;
+            frame.y += origin.y;
+        }
+
+        m_sourceRect.x += origin.x;
+        m_sourceRect.y += origin.y;
+    }
+
     void EntityAnimation::resetAnimation() noexcept {
         m_elapsedFrameTime = 0.0f;
         m_curIdx = 0;
@@ -189,6 +200,19 @@ namespace RE::Core {
             WHITE);
     }
 
+    void EntityAnimation::draw(RenderQueue& queue, const Vector2 drawPos) const {
+        assert(m_texture);
+        assert(IsTextureValid(*m_texture));
+
+        queue.drawTexture(
+            drawPass::ENTITIES,
+            0,
+            *m_texture,
+            m_sourceRect,
+            drawPos,
+            WHITE);
+    }
+
     [[nodiscard]] animType EntityAnimation::getType() const noexcept {
         return m_type;
     }
@@ -30,6 +30,7 @@
 namespace RE::Core {
     class AudioManager;
     class EntityAnimationManager;
+    class RenderQueue;
 
     struct spriteIndex {std::size_t x; std::size_t y;};
 
@@ -142,6 +143,9 @@ namespace RE::Core {
             animPlaybackMode playbackType,
             animationId animId,
             animType type);
+
+        // Moves all frame rects by origin, used when the sprite sheet was packed into an atlas
+        void offsetFrames(Vector2 origin) noexcept;
     public:
         EntityAnimation();
         EntityAnimation(
@@ -160,6 +164,7 @@ namespace RE::Core {
         virtual void resetAnimation() noexcept;
         virtual void update() noexcept;
         virtual void draw(Vector2 drawPos) const noexcept;
+        void draw(RenderQueue& queue, Vector2 drawPos) const;
 
         [[nodiscard]] animType getType() const noexcept;
     };
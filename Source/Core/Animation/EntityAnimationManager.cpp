@@ -32,15 +32,25 @@ namespace RE::Core {
         const std::string& spritePath,
         std::vector<std::unique_ptr<animationDescriptor>>& anims,
         const animationId& startingAnim,
-        std::shared_ptr<AudioManager> manager) :
+        std::shared_ptr<AudioManager> manager,
+        const std::shared_ptr<TextureAtlas>& atlas) :
             m_audioManager(std::move(manager))
     {
         for (auto& anim : anims) {
             try {
                 std::shared_ptr<Texture2D> tex;
+                Vector2 frameOrigin{};
                 const auto it = m_animTexs.find(spritePath); // NOLINT
 
-                if (it != m_animTexs.end()) {
+                // Sharing the map's atlas lets entities batch with tiles. The texture pointer
+                // shares ownership of the atlas, so the page outlives every animation using it.
+                const atlasRegion* region = atlas ? atlas->addImage(spritePath) : nullptr;
+
+                if (region) {
+                    tex = std::shared_ptr<Texture2D>(atlas, region->texture);
+                    frameOrigin = {region->rect.x, region->rect.y};
+                }
+                else if (it != m_animTexs.end()) {
                     tex = it->second;
                 }
                 else {
@@ -56,6 +66,7 @@ namespace RE::Core {
                 // Try derived FIRST because dynamic_cast to base will always be valid...
                 if (auto* keyframeDesc = dynamic_cast<keyframeSoundDescriptor*>(anim.get())) {
                     auto newKeyframeAnim = std::make_unique<KeyframeSoundAnim>(tex, *keyframeDesc, m_audioManager);
+                    newKeyframeAnim->offsetFrames(frameOrigin);
 
                     m_anims.emplace(
                         anim->id,
@@ -63,6 +74,7 @@ namespace RE::Core {
                 }
                 else if (auto* transitionDesc = dynamic_cast<transitionSoundDescriptor*>(anim.get())) {
                     auto newTransitionAnim = std::make_unique<TransitionSoundAnim>(tex, *transitionDesc, m_audioManager);
+                    newTransitionAnim->offsetFrames(frameOrigin);
 
                     m_anims.emplace(
                         anim->id,
@@ -70,6 +82,7 @@ namespace RE::Core {
                 }
                 else if (auto* animDesc = anim.get()) {
                     auto newAnim = std::make_unique<EntityAnimation>(tex, *animDesc);
+                    newAnim->offsetFrames(frameOrigin);
 
                     m_anims.emplace(
                         anim->id,
@@ -179,6 +192,10 @@ namespace RE::Core {
         m_anims.at(m_curAnimId)->draw(drawPos);
     }
 
+    void EntityAnimationManager::drawAnimation(RenderQueue& queue, const Vector2 drawPos) const {
+        m_anims.at(m_curAnimId)->draw(queue, drawPos);
+    }
+
     [[nodiscard]] animationId EntityAnimationManager::getCurrentAnimId() const noexcept {
         return m_curAnimId;
     }
@@ -24,6 +24,7 @@
 #include "EntityAnimation.h"
 #include "../Utility/Logging.h"
 #include "../Audio/AudioManager.h"
+#include "../Renderer/TextureAtlas.h"
 
 namespace RE::Core {
     static animationId resolveAnimationId(
@@ -32,7 +33,7 @@ namespace RE::Core {
 
     class EntityAnimationManager {
         std::map<animationId, std::unique_ptr<EntityAnimation>> m_anims{};
-        std::map<std::string, std::shared_ptr<Texture2D>> m_animTexs{};
+        std::map<std::string, std::shared_ptr<Texture2D>> m_animTexs{}; // Sheets that didn't fit in the atlas
         std::shared_ptr<AudioManager> m_audioManager{};
         animationId m_prevAnimId{};
         animationId m_curAnimId{};
@@ -48,7 +49,8 @@ namespace RE::Core {
         const std::string& spritePath,
         std::vector<std::unique_ptr<animationDescriptor>>& anims,
         const animationId& startingAnim,
-        std::shared_ptr<AudioManager> manager);
+        std::shared_ptr<AudioManager> manager,
+        const std::shared_ptr<TextureAtlas>& atlas);
 
         ~EntityAnimationManager();
 
@@ -62,6 +64,7 @@ namespace RE::Core {
             const direction& dir);
 
         void drawAnimation(Vector2 drawPos) const;
+        void drawAnimation(RenderQueue& queue, Vector2 drawPos) const;
 
         [[nodiscard]] animationId getCurrentAnimId() const noexcept;
         [[nodiscard]] Vector2 getSpriteSize() const noexcept;
@@ -11,8 +11,10 @@
 //
 // Class definition for Program.h, includes main game loop.
 
+#include <algorithm>
 #include <memory>
 #include <filesystem>
+#include <thread>
 #include "raylib.h"
 #include "Program.h"
 #include "LayerManager.h"
@@ -29,7 +31,8 @@ namespace RE::Core {
     Program Program::m_appInstance = Program();
 
     Program::Program() :
-        m_gameRunning(true)
+        m_gameRunning(true),
+        m_targetFrameTime(g_targetFrameTime)
         {
             #ifdef DEBUG
                 logDbg("Program created at address: ", this);
@@ -37,13 +40,25 @@ namespace RE::Core {
         }
 
     void Program::init() {
-        SetConfigFlags(FLAG_MSAA_4X_HINT);
+        // Multisampling only touches the window, and with an internal resolution only the UI is drawn there
+        if (!g_useInternalResolution) SetConfigFlags(FLAG_MSAA_4X_HINT);
         InitWindow(g_windowWidth, g_windowHeight, "Redeye");
         InitAudioDevice();
-        SetTargetFPS(60);
+        SetTargetFPS(0); // The main loop paces itself, so presenting can be timed on its own
+
+        // Frames are only worth drawing as fast as the monitor can show them
+        const int refreshRate = GetMonitorRefreshRate(GetCurrentMonitor());
+        if (refreshRate > 0) m_targetFrameTime = 1.0 / refreshRate;
 
         logDbg("Render API successfully initialized.");
 
+        // Box2D can't tell apart more than 64 threads, the main one included
+        const unsigned int workerCount = g_taskWorkerCount != 0
+            ? g_taskWorkerCount
+            : std::max(std::thread::hardware_concurrency(), 2u) - 1;
+
+        m_scheduler = std::make_unique<TaskScheduler>(std::min(workerCount, 63u));
+
         createNewSessionLog();
         saveData initSave{};
 
@@ -56,13 +71,16 @@ namespace RE::Core {
         }
 
         try {
+            // The game layer starts loading its map straight away, the menu shows the progress
+            auto gameLayer = std::make_unique<RE::Application::GameLayer>(initSave);
+
             LayerManager::getInstance().pushLayer(
                 layerKey::START_MENU,
-                std::make_unique<RE::Application::StartMenuLayer>());
+                std::make_unique<RE::Application::StartMenuLayer>(gameLayer->getMapLoader()));
 
             LayerManager::getInstance().pushLayer(
                  layerKey::GAME_LAYER,
-                 std::make_unique<RE::Application::GameLayer>(initSave));
+                 std::move(gameLayer));
         }
         catch (const std::exception& e) {
             logFatal(std::string("Program::init() failed: " + std::string(e.what())));
@@ -81,20 +99,32 @@ namespace RE::Core {
     }
 
     // Main game loop
-    void Program::run() const {
+    void Program::run() {
         logDbg("Starting main loop...");
 
         while (m_gameRunning && !WindowShouldClose()) {
+            const double frameStart = GetTime();
+
             LayerManager::getInstance().pollEvents();
 
             LayerManager::getInstance().update();
-
+            m_scheduler->runMainThreadTasks(g_mainThreadTaskBudget);
 
             BeginDrawing();
             LayerManager::getInstance().draw();
+
+            const double drawEnd = GetTime();
             EndDrawing();
+            const double presentEnd = GetTime();
 
             LayerManager::getInstance().updateLayerStack();
+
+            m_lastFrameTiming = {drawEnd - frameStart, presentEnd - drawEnd};
+
+            if (g_limitFrameRate) {
+                const double remaining = m_targetFrameTime - (GetTime() - frameStart);
+                if (remaining > 0.0) WaitTime(remaining);
+            }
         }
 
         CloseWindow();
@@ -106,6 +136,18 @@ namespace RE::Core {
         return m_appInstance;
     }
 
+    [[nodiscard]] const frameTiming& Program::getLastFrameTiming() const noexcept {
+        return m_lastFrameTiming;
+    }
+
+    [[nodiscard]] double Program::getTargetFrameTime() const noexcept {
+        return m_targetFrameTime;
+    }
+
+    [[nodiscard]] TaskScheduler& Program::getScheduler() noexcept {
+        return *m_scheduler;
+    }
+
     void Program::shutdown() noexcept {
         m_gameRunning = false;
 
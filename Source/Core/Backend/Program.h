@@ -18,10 +18,22 @@
 #ifndef APPLICATION_H
 #define APPLICATION_H
 
+#include <memory>
+#include "TaskScheduler.h"
+
 namespace RE::Core {
+    // Where the last frame's time went, in seconds
+    struct frameTiming {
+        double cpuSeconds;      // Updating layers and recording their draws
+        double presentSeconds;  // Flushing and swapping, blocks while the GPU is behind
+    };
+
     class Program {
         static Program m_appInstance;
         bool m_gameRunning;
+        frameTiming m_lastFrameTiming{};
+        double m_targetFrameTime;
+        std::unique_ptr<TaskScheduler> m_scheduler{};
 
         Program();
         ~Program() = default;
@@ -32,10 +44,17 @@ namespace RE::Core {
         Program&& operator=(Program&&) noexcept = delete;
     public:
         void init();
-        void run() const;
+        void run();
 
         static Program& getInstance() noexcept;
         void shutdown() noexcept;
+        [[nodiscard]] const frameTiming& getLastFrameTiming() const noexcept;
+
+        // One refresh of the monitor the window opened on, only valid after init()
+        [[nodiscard]] double getTargetFrameTime() const noexcept;
+
+        // Shared by every system that runs work off the main thread, only valid after init()
+        [[nodiscard]] TaskScheduler& getScheduler() noexcept;
     };
 }
 
@@ -0,0 +1,573 @@
+//
+// Author: DirgeWuff
+// Created on: 10/18/26
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Module purpose/description:
+//
+// Function definitions for TaskScheduler.h
+
+#include <algorithm>
+#include <cmath>
+#include "TaskScheduler.h"
+#include "../Utility/Logging.h"
+
+namespace RE::Core {
+    struct TaskScheduler::taskNode {
+        std::function<void()> func{};
+        rangeCallback rangeFunc{};                  // Ranges run this over [begin, end) instead of func
+        const void* rangeContext{};
+        std::size_t begin{};
+        std::size_t end{};
+        std::atomic<int> pendingDependencies{1};    // Held at one until addTask() is done adding them
+        std::atomic<bool> isStarted{};              // Whoever sets this first runs the task, it can be queued twice
+        std::atomic<bool> isDone{};
+        std::mutex mutex{};
+        std::vector<taskHandle> continuations{};
+        taskKind kind{};
+    };
+
+    static thread_local const TaskScheduler* s_threadScheduler = nullptr;
+    static thread_local std::size_t s_threadIndex = g_notSchedulerThread;
+
+    TaskScheduler::TaskScheduler(const std::size_t workerCount) :
+        m_deques(std::make_unique<taskDeque[]>(std::max(workerCount, std::size_t{1}) + 1)),
+        m_shortDeques(std::make_unique<taskDeque[]>(std::max(workerCount, std::size_t{1}) + 1)),
+        m_busyNanoseconds(std::make_unique<std::atomic<std::uint64_t>[]>(std::max(workerCount, std::size_t{1}) + 1)),
+        m_rangeStacks(std::make_unique<rangeStack[]>(std::max(workerCount, std::size_t{1}) + 1)),
+        m_threadCount(std::max(workerCount, std::size_t{1}) + 1),
+        m_mainThreadId(std::this_thread::get_id()),
+        m_lastSampleTime(std::chrono::steady_clock::now())
+    {
+        m_threads.reserve(m_threadCount - 1);
+
+        for (std::size_t i = 1; i < m_threadCount; i++) {
+            m_threads.emplace_back(&TaskScheduler::threadLoop, this, i);
+        }
+
+        #ifdef DEBUG
+            logDbg("TaskScheduler started with ", m_threadCount - 1, " workers");
+        #endif
+    }
+
+    TaskScheduler::~TaskScheduler() {
+        // Whatever is still queued gets run, anything waiting on it would never wake up otherwise
+        {
+            std::lock_guard lock(m_sleepMutex);
+            m_stopping = true;
+        }
+
+        m_tasksReady.notify_all();
+
+        for (auto& thread : m_threads) {
+            thread.join();
+        }
+
+        while (runOneTask(0, false) || runOneMainThreadTask()) {}
+    }
+
+    void TaskScheduler::threadLoop(const std::size_t threadIndex) {
+        s_threadScheduler = this;
+        s_threadIndex = threadIndex;
+
+        // Box2D hands out a burst of small tasks every step, sleeping between each of them costs more than they do
+        constexpr int spinRounds = 64;
+
+        while (true) {
+            bool ranTask = false;
+
+            for (int i = 0; i < spinRounds && !ranTask; i++) {
+                ranTask = runOneTask(threadIndex, false);
+                if (!ranTask) std::this_thread::yield();
+            }
+
+            if (ranTask) continue;
+
+            std::unique_lock lock(m_sleepMutex);
+            m_tasksReady.wait(lock, [this] { return m_stopping || m_queuedTasks.load() > 0; });
+
+            if (m_stopping && m_queuedTasks.load() == 0) return;
+        }
+    }
+
+    void TaskScheduler::taskDeque::pushBack(taskHandle task) {
+        if (count == tasks.size()) {
+            std::vector<taskHandle> grown(std::max(tasks.size() * 2, std::size_t{64}));
+
+            for (std::size_t i = 0; i < count; i++) {
+                grown[i] = std::move(tasks[(head + i) % tasks.size()]);
+            }
+
+            tasks.swap(grown);
+            head = 0;
+        }
+
+        tasks[(head + count) % tasks.size()] = std::move(task);
+        count++;
+    }
+
+    // Moving out leaves the slot empty, so a finished task isn't kept alive by a buffer it has left
+    TaskScheduler::taskHandle TaskScheduler::taskDeque::popBack() noexcept {
+        if (count == 0) return nullptr;
+
+        count--;
+        return std::move(tasks[(head + count) % tasks.size()]);
+    }
+
+    TaskScheduler::taskHandle TaskScheduler::taskDeque::popFront() noexcept {
+        if (count == 0) return nullptr;
+
+        taskHandle task = std::move(tasks[head]);
+        head = (head + 1) % tasks.size();
+        count--;
+
+        return task;
+    }
+
+    void TaskScheduler::enqueue(const taskHandle& task) {
+        if (task->kind == taskKind::MAIN_THREAD) {
+            std::lock_guard lock(m_mainThreadTasks.mutex);
+            m_mainThreadTasks.pushBack(task);
+            m_queuedMainThreadTasks.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        // Threads keep what they spawn, likely to touch the same data, except the main thread's background
+        // tasks. It only runs short ones while it waits, so those are dealt out to the workers like everyone else's.
+        const bool isShort = task->kind == taskKind::SHORT;
+        const std::size_t ownIndex = getThreadIndex();
+        const std::size_t target = ownIndex != g_notSchedulerThread && (ownIndex != 0 || isShort)
+            ? ownIndex
+            : m_nextDeque.fetch_add(1, std::memory_order_relaxed) % (m_threadCount - 1) + 1;
+
+        {
+            taskDeque& deque = isShort ? m_shortDeques[target] : m_deques[target];
+            std::lock_guard lock(deque.mutex);
+            deque.pushBack(task);
+        }
+
+        {
+            std::lock_guard lock(m_sleepMutex);
+            m_queuedTasks.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        m_tasksReady.notify_one();
+    }
+
+    // Own tasks come off the back, the most recently queued and likely still in cache,
+    // stolen ones off the front so the two ends rarely fight over the same task.
+    // Short tasks go first, something is usually waiting on them to finish a frame.
+    bool TaskScheduler::runOneTask(const std::size_t threadIndex, const bool isShortOnly) {
+        taskHandle next{};
+
+        for (taskDeque* deques : {m_shortDeques.get(), m_deques.get()}) {
+            if (next || (isShortOnly && deques == m_deques.get())) break;
+
+            {
+                taskDeque& own = deques[threadIndex];
+                std::lock_guard lock(own.mutex);
+                next = own.popBack();
+            }
+
+            for (std::size_t i = 1; i < m_threadCount && !next; i++) {
+                taskDeque& victim = deques[(threadIndex + i) % m_threadCount];
+                std::lock_guard lock(victim.mutex);
+                next = victim.popFront();
+            }
+        }
+
+        if (!next) return false;
+
+        m_queuedTasks.fetch_sub(1, std::memory_order_relaxed);
+        runTask(next, threadIndex);
+
+        return true;
+    }
+
+    bool TaskScheduler::runOneMainThreadTask() {
+        taskHandle next{};
+
+        {
+            std::lock_guard lock(m_mainThreadTasks.mutex);
+            next = m_mainThreadTasks.popFront();
+        }
+
+        if (!next) return false;
+
+        m_queuedMainThreadTasks.fetch_sub(1, std::memory_order_relaxed);
+        runTask(next, 0);
+
+        return true;
+    }
+
+    void TaskScheduler::runTask(const taskHandle& task, const std::size_t threadIndex) {
+        if (task->isStarted.exchange(true, std::memory_order_acq_rel)) return;
+
+        const auto start = std::chrono::steady_clock::now();
+        if (task->rangeFunc) {
+            task->rangeFunc(task->rangeContext, task->begin, task->end, threadIndex);
+        }
+        else {
+            task->func();
+            task->func = nullptr;
+        }
+        const auto end = std::chrono::steady_clock::now();
+
+        m_busyNanoseconds[threadIndex].fetch_add(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count(),
+            std::memory_order_relaxed);
+        m_tasksRun.fetch_add(1, std::memory_order_relaxed);
+
+        std::vector<taskHandle> continuations{};
+
+        {
+            std::lock_guard lock(task->mutex);
+            task->isDone.store(true, std::memory_order_release);
+            continuations.swap(task->continuations);
+        }
+
+        task->isDone.notify_all();
+
+        for (const auto& continuation : continuations) {
+            if (continuation->pendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1) enqueue(continuation);
+        }
+    }
+
+    TaskScheduler::taskHandle TaskScheduler::addTask(
+        std::function<void()> func,
+        const std::vector<taskHandle>& dependencies,
+        const taskKind kind)
+    {
+        auto task = std::make_shared<taskNode>();
+        task->func = std::move(func);
+        task->kind = kind;
+
+        for (const auto& dependency : dependencies) {
+            if (!dependency) continue;
+
+            std::lock_guard lock(dependency->mutex);
+            if (dependency->isDone.load(std::memory_order_acquire)) continue;
+
+            task->pendingDependencies.fetch_add(1, std::memory_order_relaxed);
+            dependency->continuations.push_back(task);
+        }
+
+        if (task->pendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1) enqueue(task);
+
+        return task;
+    }
+
+    TaskScheduler::taskHandle TaskScheduler::schedule(
+        std::function<void()> func,
+        const std::vector<taskHandle>& dependencies)
+    {
+        return addTask(std::move(func), dependencies, taskKind::BACKGROUND);
+    }
+
+    TaskScheduler::taskHandle TaskScheduler::scheduleOnMainThread(
+        std::function<void()> func,
+        const std::vector<taskHandle>& dependencies)
+    {
+        return addTask(std::move(func), dependencies, taskKind::MAIN_THREAD);
+    }
+
+    TaskScheduler::taskHandle TaskScheduler::then(const taskHandle& task, std::function<void()> func) {
+        return addTask(std::move(func), {task}, taskKind::BACKGROUND);
+    }
+
+    void TaskScheduler::wait(const taskHandle& task) {
+        if (!task || isDone(task)) return;
+
+        const std::size_t threadIndex = getThreadIndex();
+
+        // Nothing to help with from here, the scheduler's threads will get to it
+        if (threadIndex == g_notSchedulerThread) {
+            blockUntilDone(task);
+            return;
+        }
+
+        const bool isMainThread = threadIndex == 0;
+        const bool canRunHere = task->kind != taskKind::MAIN_THREAD || isMainThread;
+
+        while (!isDone(task)) {
+            // Run it here if it's ready and nobody has started it yet, rather than hoping a worker is free
+            if (canRunHere &&
+                !task->isStarted.load(std::memory_order_acquire) &&
+                task->pendingDependencies.load(std::memory_order_acquire) == 0)
+            {
+                runTask(task, threadIndex);
+                continue;
+            }
+
+            // The main thread sticks to short tasks, a background one could take longer than the whole frame.
+            // Main thread tasks still run, task may be waiting on one of them.
+            if (runOneTask(threadIndex, isMainThread)) continue;
+            if (isMainThread && runOneMainThreadTask()) continue;
+
+            std::this_thread::yield();
+        }
+    }
+
+    [[nodiscard]] bool TaskScheduler::isDone(const taskHandle& task) noexcept {
+        return !task || task->isDone.load(std::memory_order_acquire);
+    }
+
+    void TaskScheduler::blockUntilDone(const taskHandle& task) {
+        if (task) task->isDone.wait(false, std::memory_order_acquire);
+    }
+
+    // Range nodes are handed out again once they're done. A copy of one can still be sitting in a deque when
+    // wait() ran it here, and whoever pops that copy runs the node's current range if nobody has started it yet,
+    // which is why isStarted is cleared last.
+    void TaskScheduler::enqueueRange(
+        const taskHandle& task,
+        const rangeCallback callback,
+        const void* context,
+        const std::size_t begin,
+        const std::size_t end)
+    {
+        task->rangeFunc = callback;
+        task->rangeContext = context;
+        task->begin = begin;
+        task->end = end;
+        task->kind = taskKind::SHORT;
+        task->pendingDependencies.store(0, std::memory_order_relaxed);
+        task->isDone.store(false, std::memory_order_relaxed);
+        task->isStarted.store(false, std::memory_order_release);
+
+        enqueue(task);
+    }
+
+    void TaskScheduler::runRanges(
+        const std::size_t count,
+        const std::size_t minRange,
+        const rangeCallback callback,
+        const void* context)
+    {
+        if (count == 0) return;
+
+        // A few ranges per thread, so stealing can even out ranges that cost more than others
+        const std::size_t maxRanges = std::max(count / std::max(minRange, std::size_t{1}), std::size_t{1});
+        const std::size_t rangeCount = std::min(maxRanges, m_threadCount * 4);
+        const std::size_t threadIndex = getThreadIndex();
+
+        if (rangeCount == 1 || threadIndex == g_notSchedulerThread) {
+            callback(context, 0, count, threadIndex);
+            return;
+        }
+
+        const std::size_t rangeSize = (count + rangeCount - 1) / rangeCount;
+        rangeStack& stack = m_rangeStacks[threadIndex];
+        const std::size_t first = stack.used;
+
+        for (std::size_t begin = 0; begin < count; begin += rangeSize) {
+            if (stack.used == stack.tasks.size()) stack.tasks.push_back(std::make_shared<taskNode>());
+
+            enqueueRange(stack.tasks[stack.used], callback, context, begin, std::min(begin + rangeSize, count));
+            stack.used++;
+        }
+
+        const std::size_t last = stack.used;
+
+        // Copied out, a nested call made while waiting can grow the stack
+        for (std::size_t i = first; i < last; i++) {
+            const taskHandle range = stack.tasks[i];
+            wait(range);
+        }
+
+        stack.used = first;
+    }
+
+    void TaskScheduler::runMainThreadTasks(const double budgetSeconds) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(budgetSeconds);
+
+        while (std::chrono::steady_clock::now() < deadline && runOneMainThreadTask()) {}
+    }
+
+    void* TaskScheduler::enqueuePhysicsTask(
+        b2TaskCallback* task,
+        const int itemCount,
+        const int minRange,
+        void* taskContext,
+        void* userContext)
+    {
+        auto* scheduler = static_cast<TaskScheduler*>(userContext);
+
+        if (scheduler->m_freePhysicsTasks.empty()) {
+            scheduler->m_physicsTasks.push_back(std::make_unique<physicsTask>());
+            scheduler->m_freePhysicsTasks.push_back(scheduler->m_physicsTasks.back().get());
+        }
+
+        physicsTask* physics = scheduler->m_freePhysicsTasks.back();
+        scheduler->m_freePhysicsTasks.pop_back();
+
+        physics->callback = task;
+        physics->context = taskContext;
+        physics->rangeCount = 0;
+
+        // A range per thread at most, stealing evens out the rest
+        const int maxRanges = std::max(itemCount / std::max(minRange, 1), 1);
+        const int rangeCount = std::min(maxRanges, static_cast<int>(scheduler->m_threadCount));
+        const int rangeSize = (itemCount + rangeCount - 1) / rangeCount;
+
+        for (int start = 0; start < itemCount; start += rangeSize) {
+            const int end = std::min(start + rangeSize, itemCount);
+
+            if (physics->rangeCount == physics->ranges.size()) {
+                physics->ranges.push_back(std::make_shared<taskNode>());
+            }
+
+            scheduler->enqueueRange(
+                physics->ranges[physics->rangeCount],
+                runPhysicsRange,
+                physics,
+                static_cast<std::size_t>(start),
+                static_cast<std::size_t>(end));
+            physics->rangeCount++;
+        }
+
+        return physics;
+    }
+
+    void TaskScheduler::runPhysicsRange(
+        const void* context,
+        const std::size_t begin,
+        const std::size_t end,
+        const std::size_t threadIndex)
+    {
+        const auto* physics = static_cast<const physicsTask*>(context);
+
+        physics->callback(
+            static_cast<int>(begin),
+            static_cast<int>(end),
+            static_cast<std::uint32_t>(threadIndex),
+            physics->context);
+    }
+
+    // Box2D finishes its tasks in the order it queued them, and its solver's first task is the one the others
+    // wait on. wait() runs a range here if no worker has picked it up yet, so the world never waits on
+    // workers that are busy with something else.
+    void TaskScheduler::finishPhysicsTask(void* userTask, void* userContext) {
+        auto* scheduler = static_cast<TaskScheduler*>(userContext);
+        auto* physics = static_cast<physicsTask*>(userTask);
+
+        for (std::size_t i = 0; i < physics->rangeCount; i++) {
+            scheduler->wait(physics->ranges[i]);
+        }
+
+        physics->rangeCount = 0;
+        scheduler->m_freePhysicsTasks.push_back(physics);
+    }
+
+    void TaskScheduler::attachTo(b2WorldDef& worldDef) {
+        worldDef.workerCount = static_cast<int>(m_threadCount);
+        worldDef.enqueueTask = enqueuePhysicsTask;
+        worldDef.finishTask = finishPhysicsTask;
+        worldDef.userTaskContext = this;
+    }
+
+    [[nodiscard]] std::size_t TaskScheduler::getThreadCount() const noexcept {
+        return m_threadCount;
+    }
+
+    [[nodiscard]] std::size_t TaskScheduler::getThreadIndex() const noexcept {
+        if (s_threadScheduler == this) return s_threadIndex;
+        if (std::this_thread::get_id() == m_mainThreadId) return 0;
+
+        return g_notSchedulerThread;
+    }
+
+    [[nodiscard]] schedulerStats TaskScheduler::sampleStats() {
+        const auto now = std::chrono::steady_clock::now();
+        const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_lastSampleTime).count();
+
+        std::uint64_t busy = 0;
+        for (std::size_t i = 1; i < m_threadCount; i++) {
+            busy += m_busyNanoseconds[i].load(std::memory_order_relaxed);
+        }
+
+        const auto busySinceSample = static_cast<double>(busy - m_lastBusyNanoseconds);
+        const auto workerCount = m_threadCount - 1;
+
+        m_lastSampleTime = now;
+        m_lastBusyNanoseconds = busy;
+
+        return {
+            workerCount,
+            m_queuedTasks.load(std::memory_order_relaxed),
+            m_queuedMainThreadTasks.load(std::memory_order_relaxed),
+            m_tasksRun.exchange(0, std::memory_order_relaxed),
+            elapsed > 0
+                ? static_cast<float>(busySinceSample / (static_cast<double>(elapsed) * workerCount))
+                : 0.0f};
+    }
+
+    // Benchmarking
+    // =================================================================================================================
+    void benchmarkPhysicsStep(const int bodyCount, const int steps) {
+        const unsigned int maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+        const int columns = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(bodyCount))));
+
+        for (unsigned int threads = 1;; threads = std::min(threads * 2, maxThreads)) {
+            // One thread is Box2D's own single threaded path, the scheduler always brings at least one worker
+            std::unique_ptr<TaskScheduler> scheduler{};
+            b2WorldDef worldDef = b2DefaultWorldDef();
+            worldDef.gravity = {0.0f, 50.0f};
+
+            if (threads > 1) {
+                scheduler = std::make_unique<TaskScheduler>(threads - 1);
+                scheduler->attachTo(worldDef);
+            }
+
+            const b2WorldId world = b2CreateWorld(&worldDef);
+
+            b2BodyDef groundDef = b2DefaultBodyDef();
+            const b2BodyId ground = b2CreateBody(world, &groundDef);
+            const b2Polygon groundBox = b2MakeBox(static_cast<float>(columns), 1.0f);
+            const b2ShapeDef groundShape = b2DefaultShapeDef();
+            b2CreatePolygonShape(ground, &groundShape, &groundBox);
+
+            // A square stack of small boxes, dropped so they spend the run colliding and settling
+            const b2Polygon box = b2MakeBox(0.25f, 0.25f);
+            const b2ShapeDef boxShape = b2DefaultShapeDef();
+
+            for (int i = 0; i < bodyCount; i++) {
+                b2BodyDef bodyDef = b2DefaultBodyDef();
+                bodyDef.type = b2_dynamicBody;
+                bodyDef.position = {
+                    (static_cast<float>(i % columns) - static_cast<float>(columns) / 2.0f) * 0.6f,
+                    -2.0f - static_cast<float>(i / columns) * 0.6f};
+
+                const b2BodyId body = b2CreateBody(world, &bodyDef);
+                b2CreatePolygonShape(body, &boxShape, &box);
+            }
+
+            const auto start = std::chrono::steady_clock::now();
+
+            for (int i = 0; i < steps; i++) {
+                b2World_Step(world, 1.0f / 60.0f, 4);
+            }
+
+            const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+            logDbg(
+                "Physics step, ",
+                bodyCount,
+                " bodies on ",
+                threads,
+                " threads: ",
+                elapsed.count() / steps,
+                " ms average over ",
+                steps,
+                " steps");
+
+            b2DestroyWorld(world);
+
+            if (threads == maxThreads) break;
+        }
+    }
+}
@@ -0,0 +1,201 @@
+//
+// Author: DirgeWuff
+// Created on: 10/18/26
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Module purpose/description:
+//
+// Class declaration for TaskScheduler, the one set of worker threads the
+// whole engine shares. Program owns it, everything else reaches it through
+// Program::getScheduler(). Each thread has a deque of tasks it pops from
+// the back of, and steals from the front of the others' once it runs dry.
+// A task can wait on any number of others and is only queued once the last
+// of them finishes, which is all a continuation is. Tasks marked for the
+// main thread never touch the workers, they run from runMainThreadTasks()
+// once per frame, for anything that has to call into raylib or GL.
+//
+// wait() and parallelFor() put the calling thread to work instead of
+// blocking it, when it's the main thread or a worker. Waiting on the main
+// thread only ever picks up short tasks, the ranges of a parallelFor() or
+// of a Box2D step, so a map load can't end up running in the middle of a
+// frame. Background tasks scheduled from the main thread are dealt out to
+// the workers. The main thread is thread 0 and the workers 1 and up, which
+// is also how Box2D tells its workers apart once a world definition is
+// attached.
+
+#ifndef TASKSCHEDULER_H
+#define TASKSCHEDULER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "box2d/box2d.h"
+#include "../Utility/Enum.h"
+
+namespace RE::Core {
+    constexpr std::size_t g_notSchedulerThread = SIZE_MAX; // Thread index of threads the scheduler didn't start
+
+    struct schedulerStats {
+        std::size_t workerCount;
+        std::size_t queuedTasks;            // Ready and waiting in the workers' deques
+        std::size_t queuedMainThreadTasks;
+        std::size_t tasksRun;               // Since the previous sample, main thread tasks included
+        float utilization;                  // Fraction of the workers' time spent in tasks since the previous sample
+    };
+
+    class TaskScheduler {
+    public:
+        struct taskNode;
+        using taskHandle = std::shared_ptr<taskNode>;
+    private:
+        using rangeCallback = void (*)(
+            const void* context,
+            std::size_t begin,
+            std::size_t end,
+            std::size_t threadIndex);
+
+        // A ring buffer rather than a std::deque, which allocates and frees a block whenever its ends cross one.
+        // It only grows, so a steady frame queues its ranges without allocating.
+        struct taskDeque {
+            std::mutex mutex{};
+            std::vector<taskHandle> tasks{};
+            std::size_t head{};
+            std::size_t count{};
+
+            void pushBack(taskHandle task);
+            taskHandle popBack() noexcept;
+            taskHandle popFront() noexcept;
+        };
+
+        // Box2D's tasks split into ranges, kept until the world calls finishTask. The range nodes are reused
+        // along with the rest of it.
+        struct physicsTask {
+            std::vector<taskHandle> ranges{};
+            std::size_t rangeCount{};
+            b2TaskCallback* callback{};
+            void* context{};
+        };
+
+        // Range nodes of the parallelFor() calls in progress on a thread, a nested call stacks its own on top.
+        // Only the thread they belong to touches them.
+        struct rangeStack {
+            std::vector<taskHandle> tasks{};
+            std::size_t used{};
+        };
+
+        std::vector<std::thread> m_threads{};
+        std::unique_ptr<taskDeque[]> m_deques{};                    // One per thread, the main thread's first
+        std::unique_ptr<taskDeque[]> m_shortDeques{};               // Same, for taskKind::SHORT
+        std::unique_ptr<std::atomic<std::uint64_t>[]> m_busyNanoseconds{};
+        std::unique_ptr<rangeStack[]> m_rangeStacks{};              // One per thread, like the deques
+        std::size_t m_threadCount{};                                // Workers plus the main thread
+        std::thread::id m_mainThreadId{};
+        taskDeque m_mainThreadTasks{};
+        std::mutex m_sleepMutex{};
+        std::condition_variable m_tasksReady{};
+        std::atomic<std::size_t> m_queuedTasks{};
+        std::atomic<std::size_t> m_queuedMainThreadTasks{};
+        std::atomic<std::size_t> m_nextDeque{};
+        std::atomic<std::size_t> m_tasksRun{};
+        std::chrono::steady_clock::time_point m_lastSampleTime{};
+        std::uint64_t m_lastBusyNanoseconds{};
+        std::vector<std::unique_ptr<physicsTask>> m_physicsTasks{};
+        std::vector<physicsTask*> m_freePhysicsTasks{};             // Main thread only, like b2World_Step()
+        bool m_stopping{};
+
+        void threadLoop(std::size_t threadIndex);
+        void enqueue(const taskHandle& task);
+        bool runOneTask(std::size_t threadIndex, bool isShortOnly);
+        bool runOneMainThreadTask();
+        void runTask(const taskHandle& task, std::size_t threadIndex);
+        taskHandle addTask(std::function<void()> func, const std::vector<taskHandle>& dependencies, taskKind kind);
+        void enqueueRange(
+            const taskHandle& task,
+            rangeCallback callback,
+            const void* context,
+            std::size_t begin,
+            std::size_t end);
+        void runRanges(std::size_t count, std::size_t minRange, rangeCallback callback, const void* context);
+
+        static void runPhysicsRange(const void* context, std::size_t begin, std::size_t end, std::size_t threadIndex);
+
+        static void* enqueuePhysicsTask(
+            b2TaskCallback* task,
+            int itemCount,
+            int minRange,
+            void* taskContext,
+            void* userContext);
+
+        static void finishPhysicsTask(void* userTask, void* userContext);
+    public:
+        // Has to be made on the main thread, at least one worker is always started
+        explicit TaskScheduler(std::size_t workerCount);
+        ~TaskScheduler();
+
+        TaskScheduler(const TaskScheduler&) = delete;
+        TaskScheduler(TaskScheduler&&) = delete;
+        TaskScheduler& operator=(const TaskScheduler&) = delete;
+        TaskScheduler& operator=(TaskScheduler&&) = delete;
+
+        // Runs func on a worker once every dependency has finished. Null dependencies are skipped.
+        taskHandle schedule(std::function<void()> func, const std::vector<taskHandle>& dependencies = {});
+
+        // Same, but on the main thread, from runMainThreadTasks() or a wait() there
+        taskHandle scheduleOnMainThread(std::function<void()> func, const std::vector<taskHandle>& dependencies = {});
+
+        // Runs func on a worker once task has finished
+        taskHandle then(const taskHandle& task, std::function<void()> func);
+
+        // Returns once task has finished, running other tasks in the meantime on a worker, or the task itself
+        // and short tasks on the main thread
+        void wait(const taskHandle& task);
+        [[nodiscard]] static bool isDone(const taskHandle& task) noexcept;
+
+        // Blocks without running anything. For destructors, which can outlive the scheduler at shutdown,
+        // its own destructor finishes everything queued. Never on a main thread task from the main thread.
+        static void blockUntilDone(const taskHandle& task);
+
+        // Calls func(begin, end) over [0, count) split into ranges of at least minRange, and returns once they're
+        // all done. func is only referenced and the range nodes are reused, so once the first few calls have
+        // warmed things up nothing gets allocated.
+        template<typename Func>
+        void parallelFor(const std::size_t count, const std::size_t minRange, const Func& func) {
+            const rangeCallback callback = [](const void* context, std::size_t begin, std::size_t end, std::size_t) {
+                (*static_cast<const Func*>(context))(begin, end);
+            };
+
+            runRanges(count, minRange, callback, &func);
+        }
+
+        // Runs main thread tasks until none are left or budgetSeconds is up. Main thread only, once per frame.
+        void runMainThreadTasks(double budgetSeconds);
+
+        // Points the world definition's task callbacks here. Worlds made from it have to be stepped on the main
+        // thread and destroyed before the scheduler.
+        void attachTo(b2WorldDef& worldDef);
+
+        [[nodiscard]] std::size_t getThreadCount() const noexcept;
+
+        // 0 on the main thread, 1 and up on workers, g_notSchedulerThread anywhere else
+        [[nodiscard]] std::size_t getThreadIndex() const noexcept;
+
+        // Utilization and tasks run are measured from the previous call
+        [[nodiscard]] schedulerStats sampleStats();
+    };
+
+    // Steps a world of bodyCount boxes piled on the ground with 1 thread, then 2, 4 and so on up to
+    // every core, and logs the average step time for each.
+    void benchmarkPhysicsStep(int bodyCount, int steps);
+}
+
+#endif //TASKSCHEDULER_H
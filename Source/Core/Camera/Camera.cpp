@@ -23,20 +23,22 @@ namespace RE::Core {
         #endif
     }
 
-    SceneCamera::SceneCamera(const MapData& map, const float zoomLevel) {
+    SceneCamera::SceneCamera(const MapData& map, const Vector2 viewSize, const float zoomLevel) {
         m_camera = Camera2D();
 
         m_camera.offset = {
-            static_cast<float>(GetScreenWidth()) / 2.0f,
-            static_cast<float>(GetScreenHeight()) / 2.0f};
+            viewSize.x / 2.0f,
+            viewSize.y / 2.0f};
         m_camera.zoom = zoomLevel;
         m_camera.rotation = 0.0f;
+        m_baseOffset = m_camera.offset;
+        m_baseZoom = m_camera.zoom;
 
         m_cameraRect = {
-            (GetScreenWidth() - static_cast<float>(GetScreenWidth()) / m_camera.zoom) / 2.0f,
-            (GetScreenHeight() - static_cast<float>(GetScreenHeight()) / m_camera.zoom) / 2.0f,
-            GetScreenWidth() / m_camera.zoom,
-            GetScreenHeight() / m_camera.zoom
+            (viewSize.x - viewSize.x / m_camera.zoom) / 2.0f,
+            (viewSize.y - viewSize.y / m_camera.zoom) / 2.0f,
+            viewSize.x / m_camera.zoom,
+            viewSize.y / m_camera.zoom
         };
 
         m_cameraCenter = {
@@ -63,6 +65,11 @@ namespace RE::Core {
         #endif
     };
 
+    void SceneCamera::setViewScale(const float scale) {
+        m_camera.offset = {m_baseOffset.x * scale, m_baseOffset.y * scale};
+        m_camera.zoom = m_baseZoom * scale;
+    }
+
     void SceneCamera::setTarget(const Player& player) {
         const Vector2 targetEntityCenter = Vector2Add(player.getPositionCornerPx(), player.getSizePx() / 2.0f);
 
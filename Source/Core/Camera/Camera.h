@@ -23,6 +23,8 @@
 namespace RE::Core {
     class SceneCamera final : public Camera2D {
         Camera2D m_camera{};
+        Vector2 m_baseOffset{};
+        float m_baseZoom{};
         Rectangle m_cameraRect{};
         Vector2 m_cameraCenter{};
         Vector2 m_targetCenter{};
@@ -30,7 +32,8 @@ namespace RE::Core {
         Vector2 m_maxCameraPos{};
     public:
         SceneCamera();
-        SceneCamera(const MapData& map, float zoomLevel);
+        // viewSize is the size of the target the camera draws into
+        SceneCamera(const MapData& map, Vector2 viewSize, float zoomLevel);
 
         SceneCamera(SceneCamera&) = delete;
         SceneCamera(SceneCamera&&) = default;
@@ -39,6 +42,8 @@ namespace RE::Core {
 
         ~SceneCamera();
 
+        // Draws the same view into the top left scale of the target, for dynamic resolution
+        void setViewScale(float scale);
         void setTarget(const Player& player);
         void update(const Player& player);
         void cameraBegin() const;
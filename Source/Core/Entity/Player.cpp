@@ -108,17 +108,31 @@ namespace RE::Core {
         return result.normal;
     }
 
+    void Player::createBody(const b2WorldId world) {
+        assert(b2World_IsValid(world));
+
+        m_body = b2CreateBody(world, &m_bodyDef);
+        b2CreateCapsuleShape(m_body, &m_shapeDef, &m_boundingCapsule);
+
+        m_footpawSensorId = b2CreatePolygonShape(
+            m_body,
+            &m_footpawSensorShape,
+            &m_footpawSensorBox);
+    }
+
     Player::Player(
         const float centerX,
         const float centerY,
         const b2WorldId world,
-        std::shared_ptr<AudioManager> manager) :
+        std::shared_ptr<AudioManager> manager,
+        const std::shared_ptr<TextureAtlas>& atlas) :
             m_playerAnimations(loadAnimations(g_playerAnimPath)),
             m_animationManager(
                 g_playerSpritePath,
                 m_playerAnimations,
                 animationId::PLAYER_IDLE_RIGHT,
-                std::move(manager)),
+                std::move(manager),
+                atlas),
             m_playerSpritePath(g_playerSpritePath),
             m_currentDirection(direction::RIGHT),
             m_currentState(entityActionState::IDLE)
@@ -126,6 +140,7 @@ namespace RE::Core {
         m_sizePx = m_animationManager.getSpriteSize();
         m_sizeMeters = pixelsToMetersVec(m_sizePx);
         m_centerPosition = {pixelsToMeters(centerX), pixelsToMeters(centerY)};
+        m_prevCenterPosition = m_centerPosition;
         m_cornerPosition = {centerX - m_sizePx.x / 2.0f, centerY - m_sizePx.y / 2.0f};
 
         m_bodyDef = b2DefaultBodyDef();
@@ -133,9 +148,8 @@ namespace RE::Core {
         m_bodyDef.type = b2_dynamicBody;
         m_bodyDef.fixedRotation = true;
         m_bodyDef.linearDamping = 8.0f;
-        m_body = b2CreateBody(world, &m_bodyDef);
 
-        const b2Capsule boundingCapsule = {
+        m_boundingCapsule = {
             pixelsToMetersVec(Vector2(0.0f, -20.0f)),
             pixelsToMetersVec(Vector2(0.0f, 32.0f)),
             pixelsToMeters(28.0f)
@@ -147,7 +161,6 @@ namespace RE::Core {
         m_shapeDef.density = 8.0f;
         m_shapeDef.filter.categoryBits = g_playerCategoryBits;
         m_shapeDef.filter.maskBits = g_universalMaskBits;   // Using this for now, may change later...
-        b2CreateCapsuleShape(m_body, &m_shapeDef, &boundingCapsule);
 
         // Footpaw sensor :3
         m_footpawSensorBox = b2MakeOffsetBox(
@@ -181,10 +194,7 @@ namespace RE::Core {
             return;
         }
 
-        m_footpawSensorId = b2CreatePolygonShape(
-            m_body,
-            &m_footpawSensorShape,
-            &m_footpawSensorBox);
+        createBody(world);
 
         m_currentAnimId = m_animationManager.getCurrentAnimId();
 
@@ -244,12 +254,17 @@ namespace RE::Core {
                 entityActionState::IDLE;
         }
 
-        m_movementIntent = 0;
-
+        // Movement intent is left alone, pollEvents() sets it every frame and it holds for every step in it
+        m_prevCenterPosition = m_centerPosition;
         m_centerPosition = b2Body_GetPosition(m_body);
+    }
+
+    void Player::interpolate(const float alpha) {
+        const b2Vec2 center = b2Lerp(m_prevCenterPosition, m_centerPosition, alpha);
+
         m_cornerPosition = {
-            metersToPixels(m_centerPosition.x) - m_sizePx.x / 2,
-            metersToPixels(m_centerPosition.y) - m_sizePx.y / 2
+            metersToPixels(center.x) - m_sizePx.x / 2,
+            metersToPixels(center.y) - m_sizePx.y / 2
         };
 
         m_animationManager.updateAnimation(m_currentState, m_currentDirection);
@@ -260,6 +275,10 @@ namespace RE::Core {
         m_animationManager.drawAnimation(m_cornerPosition);
     }
 
+    void Player::draw(RenderQueue& queue) const {
+        m_animationManager.drawAnimation(queue, m_cornerPosition);
+    }
+
     void Player::murder() {
         LayerManager::getInstance().suspendLayer(layerKey::GAME_LAYER);
         LayerManager::getInstance().suspendOverlays();
@@ -303,9 +322,30 @@ namespace RE::Core {
             save.centerPosition,
             b2MakeRot(0.0f));
 
+        // Teleports shouldn't be interpolated across
+        m_centerPosition = save.centerPosition;
+        m_prevCenterPosition = save.centerPosition;
+
         m_dead = false;
     }
 
+    void Player::moveToWorld(const b2WorldId world, const b2Vec2 centerPosition) {
+        assert(b2Body_IsValid(m_body));
+
+        // Carry the player's momentum over so walking through an exit doesn't stop them dead
+        const b2Vec2 velocity = b2Body_GetLinearVelocity(m_body);
+        b2DestroyBody(m_body);
+
+        m_bodyDef.position = centerPosition;
+        m_centerPosition = centerPosition;
+        m_prevCenterPosition = centerPosition;
+        createBody(world);
+        b2Body_SetLinearVelocity(m_body, velocity);
+
+        // The old world's sensor end events are gone with it
+        m_activeGroundContacts = 0;
+    }
+
     void Player::addContactEvent() noexcept {
         m_activeGroundContacts++;
     }
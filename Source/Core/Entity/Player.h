@@ -29,15 +29,18 @@
 
 namespace RE::Core {
     class SceneCamera;
+    class RenderQueue;
 
     class Player final : public BoxBody, public std::enable_shared_from_this<Player> {
         b2Polygon m_footpawSensorBox{};
+        b2Capsule m_boundingCapsule{};
         std::vector<std::unique_ptr<animationDescriptor>> m_playerAnimations{};
         EntityAnimationManager m_animationManager{};
         b2ShapeDef m_footpawSensorShape{};
         std::string m_playerSpritePath{};
         std::unique_ptr<sensorInfo> m_footpawSensorInfo{};
         b2ShapeId m_footpawSensorId{};
+        b2Vec2 m_prevCenterPosition{};  // Center before the last world step, for interpolate()
         std::uint16_t m_activeGroundContacts{};
         std::uint8_t m_soundDelayClock{};
         std::int8_t m_movementIntent{};
@@ -47,6 +50,7 @@ namespace RE::Core {
         bool m_jumpIntent{};
         bool m_dead{};
 
+        void createBody(b2WorldId world);
         void moveRight(const b2WorldId& world) const;
         void moveLeft(const b2WorldId& world) const;
         void jump() const;
@@ -57,7 +61,8 @@ namespace RE::Core {
             float centerX,
             float centerY,
             b2WorldId world,
-            std::shared_ptr<AudioManager> manager);
+            std::shared_ptr<AudioManager> manager,
+            const std::shared_ptr<TextureAtlas>& atlas);
 
         ~Player() override;
 
@@ -67,10 +72,19 @@ namespace RE::Core {
         Player& operator=(Player&&) noexcept = delete;
 
         void pollEvents();
+        // Once per world step, right after it
         void update(const b2WorldId& world);
+
+        // Once per frame. Moves the drawn position alpha of the way from the previous step to the last one,
+        // and advances the animation by the frame's time.
+        void interpolate(float alpha);
         void draw() const override;
+        void draw(RenderQueue& queue) const;
         void murder();
         void reform(const saveData& save);
+
+        // Recreates the player's body in another world, for level transitions. Destroy the old world afterward.
+        void moveToWorld(b2WorldId world, b2Vec2 centerPosition);
         void addContactEvent() noexcept;
         void removeContactEvent() noexcept;
 
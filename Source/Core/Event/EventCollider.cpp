@@ -66,6 +66,15 @@ namespace RE::Core {
         b2Body_Disable(m_body);
     }
 
+    void EventCollider::destroyCollider() noexcept {
+        if (b2Body_IsValid(m_body)) b2DestroyBody(m_body);
+
+        delete m_sensorInfo;
+        m_sensorInfo = nullptr;
+        m_body = b2_nullBodyId;
+        m_shapeId = b2_nullShapeId;
+    }
+
     [[nodiscard]] Vector2 EventCollider::getSizePx() const noexcept {
         return m_sizePx;
     }
@@ -65,6 +65,9 @@ namespace RE::Core {
         EventCollider& operator=(EventCollider&& other) noexcept = delete;
 
         void disableCollider() const noexcept;
+
+        // Removes the sensor from the world and frees its sensorInfo, which copies share. Call once, on the last copy.
+        void destroyCollider() noexcept;
         [[nodiscard]] Vector2 getSizePx() const noexcept;
         [[nodiscard]] Vector2 getPosPixels() const noexcept;
         [[nodiscard]] sensorInfo getSensorInfo() const noexcept;
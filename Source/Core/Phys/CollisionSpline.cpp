@@ -9,11 +9,10 @@
 //
 // Module purpose/description:
 //
-// Class definition for CollisionSpline and all of its member functions, as well
-// as move/copy constructors, and move/copy assignment constructors, required
-// due to the nature of the vertex array.
+// Function definitions for CollisionSpline.h
 
-#include <cstring>
+#include <cmath>
+#include <utility>
 #include "box2d/types.h"
 #include "box2D/box2d.h"
 #include "CollisionSpline.h"
@@ -21,171 +20,244 @@
 #include "../Utility/Logging.h"
 
 namespace RE::Core {
-    CollisionSpline::CollisionSpline() {
-        #ifdef DEBUG
-            logDbg("Default CollisionSpline constructed at address: ", this);
-        #endif
-    }
-
     CollisionSpline::CollisionSpline(
-        const b2WorldId world,
-        const std::vector<b2Vec2>& points) :
-            m_bodyDef(b2DefaultBodyDef()),
-            m_chainDef(b2DefaultChainDef())
+        const b2ChainId chainId,
+        const std::uint32_t firstVert,
+        const std::uint32_t numVerts) noexcept :
+            m_chainId(chainId),
+            m_firstVert(firstVert),
+            m_numVerts(numVerts)
+    {}
+
+    CollisionSpline::CollisionSpline(CollisionSpline&& other) noexcept :
+        m_chainId(other.m_chainId),
+        m_firstVert(other.m_firstVert),
+        m_numVerts(other.m_numVerts)
     {
-        m_bodyDef.type = b2_staticBody;
-        m_bodyId = b2CreateBody(world, &m_bodyDef);
+        other.m_chainId = b2_nullChainId;
+        other.m_numVerts = 0;
+    }
 
-        m_numVerts = points.size();
-        m_verts = new b2Vec2[m_numVerts];
+    CollisionSpline& CollisionSpline::operator=(CollisionSpline&& other) noexcept {
+        if (this != &other) {
+            m_chainId = other.m_chainId;
+            m_firstVert = other.m_firstVert;
+            m_numVerts = other.m_numVerts;
 
-        memcpy(m_verts, points.data(), m_numVerts * sizeof(b2Vec2));
+            other.m_chainId = b2_nullChainId;
+            other.m_numVerts = 0;
+        }
 
-        m_chainMaterial = b2DefaultSurfaceMaterial();
-        m_chainMaterial.friction = 0.2f;
-        m_chainMaterial.restitution = 0.01f;
+        return *this;
+    }
 
-        m_chainDef.count = m_numVerts;
-        m_chainDef.points = m_verts;
-        m_chainDef.materials = &m_chainMaterial;
-        m_chainDef.materialCount = 1;
-        m_chainDef.isLoop = false;
-        m_chainDef.enableSensorEvents = true;
-        m_chainDef.filter.categoryBits = g_groundCategoryBits;
-        m_chainDef.filter.maskBits = g_universalMaskBits;
-        m_chainId = b2CreateChain(m_bodyId, &m_chainDef);
+    [[nodiscard]] b2ChainId CollisionSpline::getChainId() const noexcept {
+        return m_chainId;
+    }
 
-        #ifdef DEBUG
-            logDbg("CollisionObjected constructed at address: ", this);
-        #endif
+    [[nodiscard]] std::uint32_t CollisionSpline::getFirstVert() const noexcept {
+        return m_firstVert;
     }
 
-    CollisionSpline::CollisionSpline(const CollisionSpline& other) :
-        m_bodyDef(other.m_bodyDef),
-        m_chainDef(b2DefaultChainDef()),
-        m_numVerts(other.m_numVerts),
+    [[nodiscard]] std::uint32_t CollisionSpline::getVertCount() const noexcept {
+        return m_numVerts;
+    }
+
+    CollisionStore::CollisionStore(CollisionStore&& other) noexcept :
+        m_verts(std::move(other.m_verts)),
+        m_splines(std::move(other.m_splines)),
         m_bodyId(other.m_bodyId)
     {
-        m_bodyDef.type = other.m_bodyDef.type;
-
-        m_verts = new b2Vec2[m_numVerts];
+        other.m_bodyId = b2_nullBodyId;
+    }
 
-        memcpy(m_verts, other.m_verts, m_numVerts * sizeof(b2Vec2));
+    CollisionStore& CollisionStore::operator=(CollisionStore&& other) noexcept {
+        if (this != &other) {
+            m_verts = std::move(other.m_verts);
+            m_splines = std::move(other.m_splines);
+            m_bodyId = other.m_bodyId;
 
-        m_chainMaterial = other.m_chainMaterial;
-        m_chainMaterial.friction = other.m_chainMaterial.friction;
-        m_chainMaterial.restitution = other.m_chainMaterial.restitution;
+            other.m_bodyId = b2_nullBodyId;
+        }
 
-        m_chainDef.count = m_numVerts;
-        m_chainDef.points = m_verts;
-        m_chainDef.materials = &m_chainMaterial;
-        m_chainDef.materialCount = 1;
-        m_chainDef.isLoop = false;
-        m_chainId = b2CreateChain(m_bodyId, &m_chainDef);
+        return *this;
+    }
 
-        #ifdef DEBUG
-            logDbg("Copy called on CollisionSpline, new object address: ", this);
-        #endif
+    void CollisionStore::reserve(const std::size_t splineCount, const std::size_t vertCount) {
+        m_splines.reserve(splineCount);
+        m_verts.reserve(vertCount);
     }
 
-    CollisionSpline::CollisionSpline(CollisionSpline&& other) noexcept :
-        m_bodyDef(std::move(other.m_bodyDef)),
-        m_chainDef(b2DefaultChainDef()),
-        m_chainMaterial(std::move(other.m_chainMaterial)),
-        m_verts(other.m_verts),
-        m_numVerts(other.m_numVerts),
-        m_bodyId(other.m_bodyId)
-    {
-        other.m_verts = nullptr;
-        other.m_numVerts = 0;
+    void CollisionStore::addSpline(const b2WorldId world, const std::span<const b2Vec2> points) {
+        if (!b2Body_IsValid(m_bodyId)) {
+            b2BodyDef bodyDef = b2DefaultBodyDef();
+            bodyDef.type = b2_staticBody;
+            m_bodyId = b2CreateBody(world, &bodyDef);
+        }
 
-        m_chainDef.count = m_numVerts;
-        m_chainDef.points = m_verts;
-        m_chainDef.materials = &m_chainMaterial;
-        m_chainDef.materialCount = 1;
-        m_chainDef.isLoop = false;
+        const auto firstVert = static_cast<std::uint32_t>(m_verts.size());
+        m_verts.insert(m_verts.end(), points.begin(), points.end());
+
+        b2SurfaceMaterial material = b2DefaultSurfaceMaterial();
+        material.friction = 0.2f;
+        material.restitution = 0.01f;
+
+        // Box2D copies the points, the arena is only kept for drawing and shadows
+        b2ChainDef chainDef = b2DefaultChainDef();
+        chainDef.count = static_cast<int>(points.size());
+        chainDef.points = points.data();
+        chainDef.materials = &material;
+        chainDef.materialCount = 1;
+        chainDef.isLoop = false;
+        chainDef.enableSensorEvents = true;
+        chainDef.filter.categoryBits = g_groundCategoryBits;
+        chainDef.filter.maskBits = g_universalMaskBits;
+
+        m_splines.emplace_back(
+            b2CreateChain(m_bodyId, &chainDef),
+            firstVert,
+            static_cast<std::uint32_t>(points.size()));
+    }
 
-        m_chainId = b2CreateChain(m_bodyId, &m_chainDef);
+    void CollisionStore::destroySplines() noexcept {
+        if (b2Body_IsValid(m_bodyId)) b2DestroyBody(m_bodyId);
 
-        #ifdef DEBUG
-            logDbg("Move called on CollisionSpline, new address: ", this);
-        #endif
+        m_bodyId = b2_nullBodyId;
+        m_splines.clear();
+        m_verts.clear();
     }
 
-    CollisionSpline& CollisionSpline::operator=(const CollisionSpline& other) {
-        if (this != &other) {
-            delete[] m_verts;
-            m_verts = nullptr;
+    [[nodiscard]] bool CollisionStore::isShapeCountValid() const {
+        if (!b2Body_IsValid(m_bodyId)) return m_splines.empty();
 
-            m_numVerts = other.m_numVerts;
-            m_bodyDef = other.m_bodyDef;
-            m_chainDef = other.m_chainDef;
-
-            m_verts = new b2Vec2[m_numVerts];
-            memcpy(m_verts, other.m_verts, m_numVerts * sizeof(b2Vec2));
-
-            m_chainMaterial = other.m_chainMaterial;
-            m_chainMaterial.friction = other.m_chainMaterial.friction;
-            m_chainMaterial.restitution = other.m_chainMaterial.restitution;
-
-            m_chainDef.count = m_numVerts;
-            m_chainDef.points = m_verts;
-            m_chainDef.materials = &m_chainMaterial;
-            m_chainDef.materialCount = 1;
-            m_chainDef.isLoop = false;
-            m_chainId = b2CreateChain(m_bodyId, &m_chainDef);
+        std::size_t segmentCount = 0;
+        for (const auto& spline : m_splines) {
+            segmentCount += static_cast<std::size_t>(b2Chain_GetSegmentCount(spline.getChainId()));
         }
 
-        #ifdef DEBUG
-            logDbg("Copy assignment called on CollisionSpline, new object address: ", this);
-        #endif
+        return getShapeCount() == segmentCount;
+    }
 
-        return *this;
+    [[nodiscard]] std::span<const b2Vec2> CollisionStore::getVerts(const CollisionSpline& spline) const noexcept {
+        return {m_verts.data() + spline.getFirstVert(), spline.getVertCount()};
     }
 
-    CollisionSpline& CollisionSpline::operator=(CollisionSpline&& other) noexcept {
-        if (this != &other) {
-            delete[] m_verts;
+    [[nodiscard]] const std::vector<CollisionSpline>& CollisionStore::getSplines() const noexcept {
+        return m_splines;
+    }
 
-            m_numVerts = other.m_numVerts;
-            m_bodyId = other.m_bodyId;
-            m_bodyDef = std::move(other.m_bodyDef);
-            m_chainMaterial = std::move(other.m_chainMaterial);
+    [[nodiscard]] std::size_t CollisionStore::size() const noexcept {
+        return m_splines.size();
+    }
 
-            m_verts = other.m_verts;
-            other.m_verts = nullptr;
-            other.m_numVerts = 0;
+    [[nodiscard]] std::size_t CollisionStore::getShapeCount() const {
+        return b2Body_IsValid(m_bodyId) ? static_cast<std::size_t>(b2Body_GetShapeCount(m_bodyId)) : 0;
+    }
+
+    [[nodiscard]] std::size_t CollisionStore::getMemoryBytes() const noexcept {
+        return m_verts.capacity() * sizeof(b2Vec2) + m_splines.capacity() * sizeof(CollisionSpline);
+    }
+
+    [[nodiscard]] std::vector<b2Vec2> simplifyPolyline(
+        const std::span<const b2Vec2> points,
+        const float tolerance,
+        const float maxAngle)
+    {
+        if (points.empty()) return {};
 
-            m_chainDef.count = m_numVerts;
-            m_chainDef.points = m_verts;
-            m_chainDef.materials = &m_chainMaterial;
-            m_chainDef.materialCount = 1;
-            m_chainDef.isLoop = false;
+        std::vector<b2Vec2> unique;
+        unique.reserve(points.size());
+        unique.push_back(points.front());
 
-            m_chainId = b2CreateChain(m_bodyId, &m_chainDef);
+        for (std::size_t i = 1; i + 1 < points.size(); i++) {
+            if (b2Distance(points[i], unique.back()) > tolerance) unique.push_back(points[i]);
         }
 
-        #ifdef DEBUG
-            logDbg("Move assignment called on CollisionSpline, new object address: ", this);
-        #endif
+        if (unique.size() > 1 && b2Distance(unique.back(), points.back()) <= tolerance) unique.pop_back();
+        unique.push_back(points.back());
 
-        return *this;
-    }
+        // The whole line fits within tolerance, there's nothing left to make a chain of
+        if (unique.size() == 2 && b2Distance(unique.front(), unique.back()) <= tolerance) return {points.front()};
 
-    CollisionSpline::~CollisionSpline() {
-        delete[] m_verts;
-        m_verts = nullptr;
+        // Fewer than four vertices leaves no segment for Box2D to collide, so the longest segment is split in
+        // the middle until there's one. These lines are too short to simplify anyway.
+        while (unique.size() < 4) {
+            std::size_t longest = 0;
 
-        #ifdef DEBUG
-            logDbg("CollisionSpline destroyed at address: ", this);
-        #endif
-    }
+            for (std::size_t i = 1; i + 1 < unique.size(); i++) {
+                if (b2DistanceSquared(unique[i], unique[i + 1]) >
+                    b2DistanceSquared(unique[longest], unique[longest + 1]))
+                {
+                    longest = i;
+                }
+            }
 
-    [[nodiscard]] b2Vec2* CollisionSpline::getObjectVerts() const noexcept {
-        return m_verts;
-    }
+            unique.insert(
+                unique.begin() + static_cast<std::ptrdiff_t>(longest) + 1,
+                b2Lerp(unique[longest], unique[longest + 1], 0.5f));
+        }
 
-    [[nodiscard]] std::size_t CollisionSpline::getVertCount() const noexcept {
-        return m_numVerts;
+        // Chains are open, so their first and last segments are ghosts that never collide. Both ends of the
+        // colliding part are kept along with the ghost vertices, and only what lies between them is simplified,
+        // which keeps the colliding span where it was.
+        const std::size_t firstSolid = 1;
+        const std::size_t lastSolid = unique.size() - 2;
+        const float minCos = std::cos(maxAngle);
+        std::vector<bool> isKept(unique.size(), false);
+        isKept.front() = true;
+        isKept[firstSolid] = true;
+        isKept[lastSolid] = true;
+        isKept.back() = true;
+
+        // Ranges still to check, as first and last vertex, kept on a stack rather than recursing
+        std::vector<std::pair<std::size_t, std::size_t>> ranges{{firstSolid, lastSolid}};
+
+        while (!ranges.empty()) {
+            const auto [first, last] = ranges.back();
+            ranges.pop_back();
+
+            if (last - first < 2) continue;
+
+            const b2Vec2 chord = b2Sub(unique[last], unique[first]);
+            const float chordLength = b2Length(chord);
+            std::size_t split = first + 1;
+            float maxDistance = -1.0f;
+            bool isBent = false;
+
+            for (std::size_t i = first + 1; i < last; i++) {
+                const b2Vec2 toPoint = b2Sub(unique[i], unique[first]);
+                const float distance = chordLength > tolerance
+                    ? std::abs(b2Cross(chord, toPoint)) / chordLength
+                    : b2Length(toPoint);
+
+                if (distance > maxDistance) {
+                    maxDistance = distance;
+                    split = i;
+                }
+            }
+
+            for (std::size_t i = first; i < last && !isBent && chordLength > tolerance; i++) {
+                const b2Vec2 segment = b2Sub(unique[i + 1], unique[i]);
+                const float along = b2Dot(segment, chord);
+                const float across = std::abs(b2Cross(chord, segment)) / chordLength;
+
+                isBent = along < minCos * b2Length(segment) * chordLength && (across > tolerance || along < 0.0f);
+            }
+
+            if (maxDistance <= tolerance && !isBent) continue;
+
+            isKept[split] = true;
+            ranges.emplace_back(first, split);
+            ranges.emplace_back(split, last);
+        }
+
+        std::vector<b2Vec2> result;
+        result.reserve(unique.size());
+
+        for (std::size_t i = 0; i < unique.size(); i++) {
+            if (isKept[i]) result.push_back(unique[i]);
+        }
+
+        return result;
     }
-}
\ No newline at end of file
+}
@@ -9,43 +9,85 @@
 //
 // Module purpose/description:
 //
-// Class of collision objects based on a Box2D chain shape. These objects
-// are composed of multiple vertices that form a spline with collision.
-// These objects are used to compose the collision geometry for the
-// ground surface.
+// Collision objects based on a Box2D chain shape. These objects are
+// composed of multiple vertices that form a spline with collision, and are
+// used to compose the collision geometry for the ground surface.
+//
+// A CollisionStore holds every spline of a map, or of a streamed region.
+// Their vertices share one array and their chains share one static body.
+// A CollisionSpline is only a handle into the store. It owns its chain
+// and can be moved but not copied, so a chain is created exactly once
+// however often the handles get moved around.
 
 #ifndef COLLISIONOBJECT_H
 #define COLLISIONOBJECT_H
 
+#include <cstdint>
+#include <span>
 #include <vector>
 #include "box2d/types.h"
 
 namespace RE::Core {
     class CollisionSpline {
-        b2BodyDef m_bodyDef{};
-        b2ChainDef m_chainDef{};
-        b2SurfaceMaterial m_chainMaterial{};
-        b2Vec2* m_verts;
-        std::size_t m_numVerts{};
-        b2BodyId m_bodyId{};
         b2ChainId m_chainId{};
+        std::uint32_t m_firstVert{};    // Into the owning CollisionStore's vertices
+        std::uint32_t m_numVerts{};
     public:
-        CollisionSpline();
-        CollisionSpline(
-            b2WorldId world,
-            const std::vector<b2Vec2>& points);
-
-        ~CollisionSpline();
+        CollisionSpline() = default;
+        CollisionSpline(b2ChainId chainId, std::uint32_t firstVert, std::uint32_t numVerts) noexcept;
+        ~CollisionSpline() = default;
 
-        CollisionSpline(const CollisionSpline& other);
+        CollisionSpline(const CollisionSpline&) = delete;
         CollisionSpline(CollisionSpline&& other) noexcept;
-        CollisionSpline& operator=(const CollisionSpline& other);
+        CollisionSpline& operator=(const CollisionSpline&) = delete;
         CollisionSpline& operator=(CollisionSpline&& other) noexcept;
 
-        // TODO: Look into using std::span with C++ 20
-        [[nodiscard]] b2Vec2* getObjectVerts() const noexcept;
-        [[nodiscard]] std::size_t getVertCount() const noexcept;
+        [[nodiscard]] b2ChainId getChainId() const noexcept;
+        [[nodiscard]] std::uint32_t getFirstVert() const noexcept;
+        [[nodiscard]] std::uint32_t getVertCount() const noexcept;
+    };
+
+    class CollisionStore {
+        std::vector<b2Vec2> m_verts{};
+        std::vector<CollisionSpline> m_splines{};
+        b2BodyId m_bodyId{};            // Created with the first spline
+    public:
+        CollisionStore() = default;
+        ~CollisionStore() = default;
+
+        CollisionStore(const CollisionStore&) = delete;
+        CollisionStore(CollisionStore&& other) noexcept;
+        CollisionStore& operator=(const CollisionStore&) = delete;
+        CollisionStore& operator=(CollisionStore&& other) noexcept;
+
+        void reserve(std::size_t splineCount, std::size_t vertCount);
+
+        // Copies the points in and creates the spline's chain in world
+        void addSpline(b2WorldId world, std::span<const b2Vec2> points);
+
+        // Removes the body and every chain on it from the world, then empties the store. Not done on
+        // destruction, the world may already be gone by then.
+        void destroySplines() noexcept;
+
+        // True when the body holds exactly the chain segments of the splines in the store, nothing
+        // left over from chains created more than once
+        [[nodiscard]] bool isShapeCountValid() const;
+
+        [[nodiscard]] std::span<const b2Vec2> getVerts(const CollisionSpline& spline) const noexcept;
+        [[nodiscard]] const std::vector<CollisionSpline>& getSplines() const noexcept;
+        [[nodiscard]] std::size_t size() const noexcept;
+        [[nodiscard]] std::size_t getShapeCount() const;
+        [[nodiscard]] std::size_t getMemoryBytes() const noexcept;
     };
+
+    // Douglas-Peucker. Drops vertices that sit within tolerance meters of the simplified line, except
+    // where a segment turns from it by more than maxAngle radians and either climbs more than tolerance
+    // across it or doubles back along it, so steps and spikes keep their shape. Repeated vertices are
+    // dropped first. The first two and last two vertices are always kept, chains are open and Box2D doesn't
+    // collide their end segments, so only the part in between is simplified. Lines with fewer than four
+    // vertices are padded out to four. Only a line that fits within tolerance altogether comes back shorter,
+    // as its first point.
+    [[nodiscard]] std::vector<b2Vec2> simplifyPolyline(std::span<const b2Vec2> points, float tolerance, float maxAngle);
 }
 
 #endif //COLLISIONOBJECT_H
@@ -0,0 +1,74 @@
+//
+// Author: DirgeWuff
+// Created on: 10/18/26
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Module purpose/description:
+//
+// Function definitions for DynamicResolution.h
+
+#include <algorithm>
+#include "DynamicResolution.h"
+#include "../Utility/Globals.h"
+#include "../Utility/Logging.h"
+
+namespace RE::Core {
+    DynamicResolution::DynamicResolution(const double targetFrameTime) :
+        m_targetFrameTime(targetFrameTime)
+    {}
+
+    bool DynamicResolution::addFrame(const double cpuSeconds, const double presentSeconds) {
+        m_cpuTotal += cpuSeconds;
+        m_presentTotal += presentSeconds;
+        m_frameCount++;
+
+        if (m_frameCount < g_frameTimeWindow) return false;
+
+        m_averageCpu = m_cpuTotal / static_cast<double>(m_frameCount);
+        m_averagePresent = m_presentTotal / static_cast<double>(m_frameCount);
+        m_cpuTotal = 0.0;
+        m_presentTotal = 0.0;
+        m_frameCount = 0;
+
+        const double headroom = getHeadroom();
+        float scale = m_scale;
+
+        // Resolution only moves GPU time, so there's no point dropping it when the CPU alone is over budget
+        if (headroom < g_renderScaleDownHeadroom && m_averageCpu < m_targetFrameTime) {
+            scale = std::max(m_scale - g_renderScaleStep, g_minRenderScale);
+        }
+        else if (headroom > g_renderScaleUpHeadroom) {
+            scale = std::min(m_scale + g_renderScaleStep, 1.0f);
+        }
+
+        if (scale == m_scale) return false;
+
+        #ifdef DEBUG
+            logDbg("Render scale ", m_scale, " -> ", scale, ", frame time headroom: ", headroom);
+        #endif
+
+        m_scale = scale;
+
+        return true;
+    }
+
+    [[nodiscard]] float DynamicResolution::getScale() const noexcept {
+        return m_scale;
+    }
+
+    [[nodiscard]] double DynamicResolution::getHeadroom() const noexcept {
+        return 1.0 - (m_averageCpu + m_averagePresent) / m_targetFrameTime;
+    }
+
+    [[nodiscard]] double DynamicResolution::getAverageCpuSeconds() const noexcept {
+        return m_averageCpu;
+    }
+
+    [[nodiscard]] double DynamicResolution::getAveragePresentSeconds() const noexcept {
+        return m_averagePresent;
+    }
+}
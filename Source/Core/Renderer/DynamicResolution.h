@@ -0,0 +1,49 @@
+//
+// Author: DirgeWuff
+// Created on: 10/18/26
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Module purpose/description:
+//
+// Class declaration for DynamicResolution, which picks the fraction of the
+// internal resolution ResolutionScaler draws, to hold a target frame time.
+// Frame times are averaged over g_frameTimeWindow frames. The scale drops a
+// step when the average leaves less than g_renderScaleDownHeadroom of the
+// frame spare and rises a step when it leaves more than
+// g_renderScaleUpHeadroom. Anywhere in between it holds, and after a change
+// the window starts over, so the scale can't bounce between two steps.
+
+#ifndef DYNAMICRESOLUTION_H
+#define DYNAMICRESOLUTION_H
+
+#include <cstddef>
+
+namespace RE::Core {
+    class DynamicResolution {
+        double m_targetFrameTime{};
+        double m_cpuTotal{};
+        double m_presentTotal{};
+        double m_averageCpu{};
+        double m_averagePresent{};
+        std::size_t m_frameCount{};
+        float m_scale{1.0f};
+    public:
+        explicit DynamicResolution(double targetFrameTime);
+
+        // Returns true when the scale changed
+        bool addFrame(double cpuSeconds, double presentSeconds);
+
+        [[nodiscard]] float getScale() const noexcept;
+
+        // Fraction of the target frame time the last window left spare, negative when over budget
+        [[nodiscard]] double getHeadroom() const noexcept;
+        [[nodiscard]] double getAverageCpuSeconds() const noexcept;
+        [[nodiscard]] double getAveragePresentSeconds() const noexcept;
+    };
+}
+
+#endif //DYNAMICRESOLUTION_H
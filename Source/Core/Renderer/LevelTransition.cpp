@@ -0,0 +1,179 @@
+//
+// Author: DirgeWuff
+// Created on: 10/18/26
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Module purpose/description:
+//
+// Function definitions for LevelTransition.h
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include "box2d/box2d.h"
+#include "LevelTransition.h"
+#include "../Utility/Globals.h"
+#include "../Utility/Logging.h"
+
+namespace RE::Core {
+    LevelTransition::LevelTransition(const b2WorldDef& worldDef, const std::shared_ptr<TextureAtlas>& atlas) :
+        m_worldDef(worldDef),
+        m_atlas(atlas),
+        m_world(b2_nullWorldId)
+    {
+
+    }
+
+    LevelTransition::~LevelTransition() {
+        cancel();
+        destroyAbandoned(true);
+    }
+
+    void LevelTransition::startPrefetch(const mapExit& exit) {
+        m_world = b2CreateWorld(&m_worldDef);
+        m_loader = std::make_unique<MapLoader>(exit.targetMap, m_world, m_atlas);
+        m_spawnPx = exit.targetPos;
+        m_targetMap = exit.targetMap;
+
+        #ifdef DEBUG
+            logDbg("Prefetching next map: ", exit.targetMap.string());
+        #endif
+    }
+
+    void LevelTransition::destroyAbandoned(const bool isBlocking) {
+        std::erase_if(m_abandoned, [isBlocking](abandonedPrefetch& prefetch) {
+            const bool isBusy =
+                (prefetch.loader && prefetch.loader->isBusy()) || (prefetch.streamer && prefetch.streamer->isBusy());
+
+            if (isBusy && !isBlocking) return false;
+
+            // Streamed regions and the loader both own bodies in the world, so they go first
+            prefetch.streamer.reset();
+            prefetch.loader.reset();
+
+            unloadMapPhysics(prefetch.map);
+            unloadMap(prefetch.map);
+
+            if (b2World_IsValid(prefetch.world)) b2DestroyWorld(prefetch.world);
+
+            return true;
+        });
+    }
+
+    void LevelTransition::update(const MapData& currentMap, const Vector2 playerPx, const double budgetSeconds) {
+        destroyAbandoned(false);
+
+        const std::size_t exitIndex = findNearestMapExit(currentMap, playerPx, g_mapPrefetchDistance);
+
+        // Walking away from every exit keeps the last prefetch around, the player is likely to turn back
+        if (exitIndex != g_noMapExit && exitIndex != m_exitIndex) {
+            const mapExit& exit = currentMap.mapExits[exitIndex];
+
+            if (m_exitIndex == g_noMapExit) {
+                startPrefetch(exit);
+                m_exitIndex = exitIndex;
+            }
+            else if (exit.targetMap == m_targetMap) {
+                // Same map, only the spawn point moves. Without a target position it's set once the map is in.
+                m_exitIndex = exitIndex;
+
+                if (exit.hasTargetPos) m_spawnPx = exit.targetPos;
+                else if (!m_loader) m_spawnPx = m_map.playerStartPos;
+            }
+            else {
+                const float distance = getMapExitDistance(exit, playerPx);
+                const float currentDistance = getMapExitDistance(currentMap.mapExits[m_exitIndex], playerPx);
+
+                if (distance == 0.0f || distance + g_mapPrefetchHysteresis < currentDistance) {
+                    cancel();
+                    startPrefetch(exit);
+                    m_exitIndex = exitIndex;
+                }
+            }
+        }
+
+        if (m_exitIndex == g_noMapExit) return;
+
+        if (m_loader) {
+            if (!m_loader->update(budgetSeconds)) return;
+
+            m_map = m_loader->takeMap();
+            m_loader.reset();
+
+            if (!currentMap.mapExits[m_exitIndex].hasTargetPos) {
+                m_spawnPx = m_map.playerStartPos;
+            }
+
+            if (m_map.isStreamed) {
+                m_streamer = std::make_unique<WorldStreamer>(m_map, m_world);
+            }
+        }
+        else if (m_streamer) {
+            m_streamer->update(m_spawnPx, budgetSeconds);
+        }
+    }
+
+    [[nodiscard]] bool LevelTransition::isReadyFor(const std::size_t exitIndex) const {
+        if (exitIndex == g_noMapExit || exitIndex != m_exitIndex || m_loader) return false;
+
+        return !m_streamer || m_streamer->isLoadedAround(m_spawnPx);
+    }
+
+    [[nodiscard]] preparedLevel LevelTransition::takeLevel() {
+        assert(isReadyFor(m_exitIndex));
+
+        preparedLevel level = {std::move(m_map), m_world, std::move(m_streamer), m_spawnPx};
+        m_map = {};
+        m_world = b2_nullWorldId;
+        m_targetMap.clear();
+        m_exitIndex = g_noMapExit;
+
+        return level;
+    }
+
+    void LevelTransition::cancel() {
+        if (m_loader || m_streamer || b2World_IsValid(m_world)) {
+            m_abandoned.push_back({std::move(m_loader), std::move(m_streamer), std::move(m_map), m_world});
+
+            #ifdef DEBUG
+                logDbg("Abandoned prefetch of map: ", m_targetMap.string());
+            #endif
+        }
+
+        m_loader = nullptr;
+        m_streamer = nullptr;
+        m_map = {};
+        m_world = b2_nullWorldId;
+        m_targetMap.clear();
+        m_exitIndex = g_noMapExit;
+    }
+
+    [[nodiscard]] float getMapExitDistance(const mapExit& exit, const Vector2 positionPx) {
+        const Rectangle& rect = exit.rect;
+
+        const float dx = std::max({rect.x - positionPx.x, 0.0f, positionPx.x - (rect.x + rect.width)});
+        const float dy = std::max({rect.y - positionPx.y, 0.0f, positionPx.y - (rect.y + rect.height)});
+
+        return std::sqrt(dx * dx + dy * dy);
+    }
+
+    [[nodiscard]] std::size_t findNearestMapExit(const MapData& map, const Vector2 positionPx, const float maxDistance) {
+        std::size_t nearest = g_noMapExit;
+        float nearestDistance = maxDistance;
+
+        for (std::size_t i = 0; i < map.mapExits.size(); i++) {
+            const float distance = getMapExitDistance(map.mapExits[i], positionPx);
+
+            if (distance <= nearestDistance) {
+                nearest = i;
+                nearestDistance = distance;
+            }
+        }
+
+        return nearest;
+    }
+}
@@ -0,0 +1,99 @@
+//
+// Author: DirgeWuff
+// Created on: 10/18/26
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Module purpose/description:
+//
+// Class declaration for LevelTransition, which loads the map behind a "MapExit"
+// event collider while the player is still walking toward it. Once the player
+// gets within g_mapPrefetchDistance of an exit, the target map is staged on a
+// worker thread by a MapLoader into a physics world of its own, and its textures
+// and Box2D objects are finished a little each frame. By the time the player
+// touches the exit the whole level is built, so GameLayer only has to swap it in.
+//
+// Exits leading to the same map share one prefetch, and another exit only takes
+// over once it's g_mapPrefetchHysteresis closer, so walking between two exits
+// doesn't restart the load over and over. A prefetch that is thrown away while a
+// worker still has part of it is kept until the worker is done, and destroyed
+// then, rather than stalling the frame.
+
+#ifndef LEVELTRANSITION_H
+#define LEVELTRANSITION_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "MapLoader.h"
+#include "WorldStreamer.h"
+
+namespace RE::Core {
+    constexpr std::size_t g_noMapExit = SIZE_MAX;
+
+    // A fully loaded map in its own world, ready to replace the current one
+    struct preparedLevel {
+        MapData map;
+        b2WorldId world;
+        std::unique_ptr<WorldStreamer> streamer; // Streamed maps only
+        Vector2 spawnPx;                         // Player center
+    };
+
+    // A prefetch that's no longer wanted, waiting for its workers before it's destroyed
+    struct abandonedPrefetch {
+        std::unique_ptr<MapLoader> loader;
+        std::unique_ptr<WorldStreamer> streamer;
+        MapData map;
+        b2WorldId world;
+    };
+
+    class LevelTransition {
+        b2WorldDef m_worldDef{};
+        std::shared_ptr<TextureAtlas> m_atlas{};
+        std::unique_ptr<MapLoader> m_loader{};          // Null once the map has been taken from it
+        std::unique_ptr<WorldStreamer> m_streamer{};
+        MapData m_map{};
+        b2WorldId m_world{};
+        Vector2 m_spawnPx{};
+        fs::path m_targetMap{};
+        std::size_t m_exitIndex{g_noMapExit};           // Exit of the current map being prefetched
+        std::vector<abandonedPrefetch> m_abandoned{};
+
+        void startPrefetch(const mapExit& exit);
+        void destroyAbandoned(bool isBlocking);
+    public:
+        LevelTransition(const b2WorldDef& worldDef, const std::shared_ptr<TextureAtlas>& atlas);
+        ~LevelTransition();
+
+        LevelTransition(const LevelTransition&) = delete;
+        LevelTransition(LevelTransition&&) = delete;
+        LevelTransition& operator=(const LevelTransition&) = delete;
+        LevelTransition& operator=(LevelTransition&&) = delete;
+
+        // Starts prefetching the exit of currentMap closest to playerPx once it's in range, and moves the
+        // prefetch along for at most budgetSeconds. Heading for an exit to a different map throws the old
+        // prefetch away, once the new exit is g_mapPrefetchHysteresis closer or the player is in it.
+        // Main thread only, call once per frame.
+        void update(const MapData& currentMap, Vector2 playerPx, double budgetSeconds);
+
+        // True once the map behind the exit is loaded, and for streamed maps, loaded around the spawn point
+        [[nodiscard]] bool isReadyFor(std::size_t exitIndex) const;
+
+        // Hands over the prepared level. Only valid once isReadyFor() has returned true.
+        [[nodiscard]] preparedLevel takeLevel();
+
+        // Throws away any prefetched map along with its world, once no worker is using them anymore
+        void cancel();
+    };
+
+    // Distance from positionPx to the edge of exit, zero inside it
+    [[nodiscard]] float getMapExitDistance(const mapExit& exit, Vector2 positionPx);
+
+    // Index into MapData::mapExits of the exit closest to positionPx, or g_noMapExit if none are within maxDistance
+    [[nodiscard]] std::size_t findNearestMapExit(const MapData& map, Vector2 positionPx, float maxDistance);
+}
+
+#endif //LEVELTRANSITION_H
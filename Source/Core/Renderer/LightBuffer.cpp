@@ -0,0 +1,111 @@
+//
+// Author: DirgeWuff
+// Created on: 10/18/26
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Module purpose/description:
+//
+// Function definitions for LightBuffer.h
+
+#include <algorithm>
+#include "rlgl.h"
+#include "LightBuffer.h"
+#include "../Utility/Logging.h"
+
+namespace RE::Core {
+    // LoadRenderTexture() is 8 bits per channel, which would clip overlapping lights at 1.0
+    static RenderTexture2D loadHalfFloatTarget(const int width, const int height) {
+        RenderTexture2D target{};
+        target.id = rlLoadFramebuffer();
+        if (target.id == 0) return target;
+
+        rlEnableFramebuffer(target.id);
+
+        target.texture.id = rlLoadTexture(nullptr, width, height, PIXELFORMAT_UNCOMPRESSED_R16G16B16A16, 1);
+        target.texture.width = width;
+        target.texture.height = height;
+        target.texture.mipmaps = 1;
+        target.texture.format = PIXELFORMAT_UNCOMPRESSED_R16G16B16A16;
+
+        rlFramebufferAttach(target.id, target.texture.id, RL_ATTACHMENT_COLOR_CHANNEL0, RL_ATTACHMENT_TEXTURE2D, 0);
+
+        if (!rlFramebufferComplete(target.id)) {
+            rlDisableFramebuffer();
+            UnloadRenderTexture(target);
+            return {};
+        }
+
+        rlDisableFramebuffer();
+
+        return target;
+    }
+
+    LightBuffer::LightBuffer(const int sceneWidth, const int sceneHeight, const int downscale) :
+        m_width(std::max(sceneWidth / downscale, 1)),
+        m_height(std::max(sceneHeight / downscale, 1))
+    {
+        m_target = loadHalfFloatTarget(m_width, m_height);
+
+        if (m_target.id == 0) {
+            logFatal("Unable to create lighting buffer. LightBuffer::LightBuffer(Args...)");
+            return;
+        }
+
+        m_compositeShader = LoadShader(NULL, "../assets/Shaders/lightComposite.fsh"); // NOLINT
+
+        if (!IsShaderValid(m_compositeShader)) {
+            logFatal("Unable to load shader. LightBuffer::LightBuffer(Args...)");
+            return;
+        }
+
+        m_lightBufferLoc = GetShaderLocation(m_compositeShader, "lightBuffer");
+
+        const Vector2 size = {static_cast<float>(m_width), static_cast<float>(m_height)};
+        SetShaderValue(
+            m_compositeShader,
+            GetShaderLocation(m_compositeShader, "lightBufferSize"),
+            &size,
+            SHADER_UNIFORM_VEC2);
+    }
+
+    LightBuffer::~LightBuffer() {
+        UnloadShader(m_compositeShader);
+        UnloadRenderTexture(m_target);
+    }
+
+    void LightBuffer::begin() const {
+        BeginTextureMode(m_target);
+        ClearBackground(BLACK);
+
+        // Alpha holds the scene's brightness, not coverage, so it can't be blended
+        rlSetBlendFactors(RL_ONE, RL_ZERO, RL_FUNC_ADD);
+        BeginBlendMode(BLEND_CUSTOM);
+    }
+
+    void LightBuffer::end() const {
+        EndBlendMode();
+        EndTextureMode();
+    }
+
+    void LightBuffer::drawComposited(const RenderTexture2D& scene, const Rectangle source, const Rectangle dest) const {
+        BeginShaderMode(m_compositeShader);
+            SetShaderValueTexture(m_compositeShader, m_lightBufferLoc, m_target.texture);
+
+            DrawTexturePro(
+                scene.texture,
+                source,
+                dest,
+                {0.0f, 0.0f},
+                0.0f,
+                WHITE);
+        EndShaderMode();
+    }
+
+    [[nodiscard]] Rectangle LightBuffer::getRect() const noexcept {
+        return {0.0f, 0.0f, static_cast<float>(m_width), static_cast<float>(m_height)};
+    }
+}
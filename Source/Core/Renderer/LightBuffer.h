@@ -0,0 +1,51 @@
+//
+// Author: DirgeWuff
+// Created on: 10/18/26
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Module purpose/description:
+//
+// Class declaration for LightBuffer, a render target a fraction of the
+// screen's size that lighting.fsh writes the light term into instead of
+// lighting every screen pixel. The scene's brightness goes in alpha, and
+// drawComposited() uses it to upscale the light without bleeding it across
+// edges in the scene, then multiplies the full resolution scene by it.
+
+#ifndef LIGHTBUFFER_H
+#define LIGHTBUFFER_H
+
+#include "raylib.h"
+
+namespace RE::Core {
+    class LightBuffer {
+        RenderTexture2D m_target{};
+        Shader m_compositeShader{};
+        int m_lightBufferLoc{};
+        int m_width{};
+        int m_height{};
+    public:
+        // downscale divides the scene's size on each axis
+        LightBuffer(int sceneWidth, int sceneHeight, int downscale);
+        ~LightBuffer();
+
+        LightBuffer(const LightBuffer&) = delete;
+        LightBuffer(LightBuffer&&) = delete;
+        LightBuffer& operator=(const LightBuffer&) = delete;
+        LightBuffer& operator=(LightBuffer&&) = delete;
+
+        // Everything drawn between these lands in the buffer as is, alpha included
+        void begin() const;
+        void end() const;
+
+        // Draws source of scene to the current target, lit by the buffer, stretched over dest
+        void drawComposited(const RenderTexture2D& scene, Rectangle source, Rectangle dest) const;
+
+        [[nodiscard]] Rectangle getRect() const noexcept;
+    };
+}
+
+#endif //LIGHTBUFFER_H
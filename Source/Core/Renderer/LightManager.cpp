@@ -0,0 +1,290 @@
+//
+// Author: DirgeWuff
+// Created on: 10/18/26
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Module purpose/description:
+//
+// Function definitions for LightManager.h
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <ranges>
+#include "rlgl.h"
+#include "LightManager.h"
+#include "WorldStreamer.h"
+#include "../Camera/Camera.h"
+#include "../Utility/Globals.h"
+
+namespace RE::Core {
+    static Texture2D loadDataTexture(const int width, const int height, const PixelFormat format) {
+        Texture2D texture{};
+        texture.id = rlLoadTexture(nullptr, width, height, format, 1);
+        texture.width = width;
+        texture.height = height;
+        texture.mipmaps = 1;
+        texture.format = format;
+
+        return texture;
+    }
+
+    // Somewhere between 0 and 1, different for each light
+    static float getFlickerNoise(const double time, const std::size_t seed) {
+        const auto t = static_cast<float>(time);
+        const auto s = static_cast<float>(seed);
+
+        return 0.5f + 0.5f * std::sin(t * 11.3f + s * 2.17f) * std::sin(t * 4.1f + s * 5.3f);
+    }
+
+    LightManager::LightManager(const Shader& shader, const int screenWidth, const int screenHeight) :
+        m_screenSize{static_cast<float>(screenWidth), static_cast<float>(screenHeight)},
+        m_tilesX((screenWidth + g_lightTileSize - 1) / g_lightTileSize),
+        m_tilesY((screenHeight + g_lightTileSize - 1) / g_lightTileSize)
+    {
+        const std::size_t tileCount = static_cast<std::size_t>(m_tilesX) * m_tilesY;
+        const auto indexRows = static_cast<int>(
+            (tileCount * g_maxLightsPerTile + g_lightIndexTextureWidth - 1) / g_lightIndexTextureWidth);
+
+        m_lightDataTexture = loadDataTexture(4, static_cast<int>(g_maxLights), PIXELFORMAT_UNCOMPRESSED_R32G32B32A32);
+        m_tileGridTexture = loadDataTexture(m_tilesX, m_tilesY, PIXELFORMAT_UNCOMPRESSED_R32G32B32A32);
+        m_lightIndexTexture = loadDataTexture(g_lightIndexTextureWidth, indexRows, PIXELFORMAT_UNCOMPRESSED_R32);
+
+        m_tileCounts.resize(tileCount);
+        m_tileGrid.resize(tileCount * 4);
+        m_lightData.reserve(g_maxLights * 16);
+
+        m_lightDataLoc = GetShaderLocation(shader, "lightData");
+        m_lightGridLoc = GetShaderLocation(shader, "lightGrid");
+        m_lightIndicesLoc = GetShaderLocation(shader, "lightIndices");
+        m_shadowMaskLoc = GetShaderLocation(shader, "shadowMask");
+
+        const int tileSize = g_lightTileSize;
+        const int indexWidth = g_lightIndexTextureWidth;
+        SetShaderValue(shader, GetShaderLocation(shader, "lightTileSize"), &tileSize, SHADER_UNIFORM_INT);
+        SetShaderValue(shader, GetShaderLocation(shader, "lightIndexWidth"), &indexWidth, SHADER_UNIFORM_INT);
+    }
+
+    LightManager::~LightManager() {
+        UnloadTexture(m_lightDataTexture);
+        UnloadTexture(m_tileGridTexture);
+        UnloadTexture(m_lightIndexTexture);
+    }
+
+    std::size_t LightManager::addLight(const lightSource& light) {
+        if (!m_freeSlots.empty()) {
+            const std::size_t id = m_freeSlots.back();
+            m_freeSlots.pop_back();
+
+            m_lights[id] = light;
+            m_isUsed[id] = true;
+
+            return id;
+        }
+
+        m_lights.push_back(light);
+        m_isUsed.push_back(true);
+
+        return m_lights.size() - 1;
+    }
+
+    void LightManager::removeLight(const std::size_t id) {
+        assert(id < m_lights.size() && m_isUsed[id]);
+
+        m_isUsed[id] = false;
+        m_freeSlots.push_back(id);
+        m_shadows.forgetLight(id);
+    }
+
+    [[nodiscard]] lightSource& LightManager::getLight(const std::size_t id) {
+        assert(id < m_lights.size() && m_isUsed[id]);
+
+        return m_lights[id];
+    }
+
+    void LightManager::setMapLights(const MapData& map) {
+        for (const std::size_t id : m_mapLights) {
+            removeLight(id);
+        }
+
+        m_mapLights.clear();
+        m_mapLights.reserve(map.lights.size());
+
+        for (const auto& light : map.lights) {
+            m_mapLights.push_back(addLight(light));
+        }
+
+        m_isShadowGeometryDirty = true;
+    }
+
+    void LightManager::updateShadowGeometry(const MapData& map, const WorldStreamer* streamer) {
+        const std::uint64_t streamerVersion = streamer ? streamer->getPhysicsVersion() : 0;
+        if (!m_isShadowGeometryDirty && streamerVersion == m_streamerPhysicsVersion) return;
+
+        m_shadows.clearGeometry();
+        m_shadows.addGeometry(map.collisionObjects);
+
+        if (streamer) {
+            for (const auto& region : std::views::values(streamer->getRegions())) {
+                if (region.state == regionState::LOADED) m_shadows.addGeometry(region.collisionObjects);
+            }
+        }
+
+        m_shadows.finishGeometry();
+        m_streamerPhysicsVersion = streamerVersion;
+        m_isShadowGeometryDirty = false;
+    }
+
+    void LightManager::update(const SceneCamera& camera, const double time) {
+        const Vector2 target = camera.getCameraTarget();
+        const Vector2 offset = camera.getCameraOffset();
+        const float zoom = camera.getCameraZoom();
+
+        m_stats = {};
+        m_shadows.beginFrame();
+        m_lightData.clear();
+        m_visibleRanges.clear();
+        std::ranges::fill(m_tileCounts, 0u);
+
+        // Pack every light on screen, in the shader's y up screen space
+        for (std::size_t i = 0; i < m_lights.size() && m_visibleRanges.size() < g_maxLights; i++) {
+            if (!m_isUsed[i]) continue;
+
+            const lightSource& light = m_lights[i];
+            m_stats.totalLights++;
+
+            const Vector2 position = {
+                (light.position.x - target.x) * zoom + offset.x,
+                m_screenSize.y - ((light.position.y - target.y) * zoom + offset.y)};
+            const float radius = light.radius * zoom;
+            const Vector2 halfSize = {light.halfSize.x * zoom, light.halfSize.y * zoom};
+            const Vector2 reach = light.type == lightType::AREA
+                ? Vector2{halfSize.x + radius, halfSize.y + radius}
+                : Vector2{radius, radius};
+
+            if (position.x + reach.x < 0.0f || position.x - reach.x > m_screenSize.x ||
+                position.y + reach.y < 0.0f || position.y - reach.y > m_screenSize.y)
+            {
+                continue;
+            }
+
+            const float intensity = light.intensity * (1.0f - light.flicker * getFlickerNoise(time, i));
+
+            m_lightData.insert(m_lightData.end(), {
+                position.x,
+                position.y,
+                radius,
+                intensity,
+                static_cast<float>(light.color.r) / 255.0f,
+                static_cast<float>(light.color.g) / 255.0f,
+                static_cast<float>(light.color.b) / 255.0f,
+                static_cast<float>(light.type)});
+
+            if (light.type == lightType::CONE) {
+                const float halfAngle = light.coneAngle * 0.5f;
+
+                m_lightData.insert(m_lightData.end(), {
+                    light.direction.x,
+                    -light.direction.y,
+                    std::cos(halfAngle),
+                    std::cos(halfAngle * (1.0f - light.softness))});
+            }
+            else {
+                m_lightData.insert(m_lightData.end(), {halfSize.x, halfSize.y, 0.0f, 0.0f});
+            }
+
+            // Area lights don't have a single point to see from, so they don't cast shadows
+            const shadowCell shadow = light.type == lightType::AREA
+                ? shadowCell{}
+                : m_shadows.getShadow(i, light.position, light.radius);
+
+            m_lightData.insert(m_lightData.end(), {
+                shadow.centerUv.x,
+                shadow.centerUv.y,
+                shadow.halfSizeUv,
+                shadow.hasShadow ? 1.0f : 0.0f});
+
+            const tileRange range = {
+                std::clamp(static_cast<int>((position.x - reach.x) / g_lightTileSize), 0, m_tilesX - 1),
+                std::clamp(static_cast<int>((position.y - reach.y) / g_lightTileSize), 0, m_tilesY - 1),
+                std::clamp(static_cast<int>((position.x + reach.x) / g_lightTileSize), 0, m_tilesX - 1),
+                std::clamp(static_cast<int>((position.y + reach.y) / g_lightTileSize), 0, m_tilesY - 1)};
+
+            m_visibleRanges.push_back(range);
+
+            for (int y = range.minY; y <= range.maxY; y++) {
+                for (int x = range.minX; x <= range.maxX; x++) {
+                    m_tileCounts[y * m_tilesX + x]++;
+                }
+            }
+        }
+
+        m_stats.visibleLights = m_visibleRanges.size();
+        m_stats.shadowsRecomputed = m_shadows.getRecomputedCount();
+        m_stats.shadowCacheHits = m_shadows.getCacheHitCount();
+        m_shadows.drawPendingCells();
+
+        // Lay each tile's list out back to back, then fill them in light order
+        std::uint32_t nextIndex = 0;
+
+        for (std::size_t tile = 0; tile < m_tileCounts.size(); tile++) {
+            const std::uint32_t count = m_tileCounts[tile];
+            const auto capped = static_cast<std::uint32_t>(std::min<std::size_t>(count, g_maxLightsPerTile));
+
+            m_stats.maxLightsInTile = std::max<std::size_t>(m_stats.maxLightsInTile, count);
+            if (count > g_maxLightsPerTile) m_stats.overflowingTiles++;
+
+            m_tileGrid[tile * 4] = static_cast<float>(nextIndex);
+            m_tileGrid[tile * 4 + 1] = 0.0f;
+            nextIndex += capped;
+        }
+
+        const std::size_t indexRows = (nextIndex + g_lightIndexTextureWidth - 1) / g_lightIndexTextureWidth;
+        m_lightIndices.assign(indexRows * g_lightIndexTextureWidth, 0.0f);
+
+        for (std::size_t light = 0; light < m_visibleRanges.size(); light++) {
+            const tileRange& range = m_visibleRanges[light];
+
+            for (int y = range.minY; y <= range.maxY; y++) {
+                for (int x = range.minX; x <= range.maxX; x++) {
+                    float* tile = &m_tileGrid[(static_cast<std::size_t>(y) * m_tilesX + x) * 4];
+                    if (tile[1] >= static_cast<float>(g_maxLightsPerTile)) continue;
+
+                    m_lightIndices[static_cast<std::size_t>(tile[0] + tile[1])] = static_cast<float>(light);
+                    tile[1] += 1.0f;
+                }
+            }
+        }
+
+        if (!m_visibleRanges.empty()) {
+            UpdateTextureRec(
+                m_lightDataTexture,
+                {0.0f, 0.0f, 4.0f, static_cast<float>(m_visibleRanges.size())},
+                m_lightData.data());
+        }
+
+        if (indexRows > 0) {
+            UpdateTextureRec(
+                m_lightIndexTexture,
+                {0.0f, 0.0f, static_cast<float>(g_lightIndexTextureWidth), static_cast<float>(indexRows)},
+                m_lightIndices.data());
+        }
+
+        UpdateTexture(m_tileGridTexture, m_tileGrid.data());
+    }
+
+    void LightManager::bindTextures(const Shader& shader) const {
+        SetShaderValueTexture(shader, m_lightDataLoc, m_lightDataTexture);
+        SetShaderValueTexture(shader, m_lightGridLoc, m_tileGridTexture);
+        SetShaderValueTexture(shader, m_lightIndicesLoc, m_lightIndexTexture);
+        SetShaderValueTexture(shader, m_shadowMaskLoc, m_shadows.getMaskTexture());
+    }
+
+    [[nodiscard]] const lightStats& LightManager::getStats() const noexcept {
+        return m_stats;
+    }
+}
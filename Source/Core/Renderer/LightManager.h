@@ -0,0 +1,105 @@
+//
+// Author: DirgeWuff
+// Created on: 10/18/26
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Module purpose/description:
+//
+// Class declaration for LightManager, which feeds lighting.fsh its lights.
+// Every frame the lights on screen are packed into a float texture, and the
+// screen is split into g_lightTileSize tiles, each with the list of lights
+// that can reach it. The shader only loops over its own tile's list, so the
+// cost per fragment is capped by g_maxLightsPerTile no matter how many
+// lights the map has. Shadows come from ShadowCaster. The shader stays owned
+// by GameLayer, see the note at the top of GameLayer.cpp.
+
+#ifndef LIGHTMANAGER_H
+#define LIGHTMANAGER_H
+
+#include <cstdint>
+#include <vector>
+#include "raylib.h"
+#include "ShadowCaster.h"
+#include "Tilemap.h"
+
+namespace RE::Core {
+    class SceneCamera;
+    class WorldStreamer;
+
+    struct lightStats {
+        std::size_t totalLights;
+        std::size_t visibleLights;
+        std::size_t maxLightsInTile;
+        std::size_t overflowingTiles;   // Tiles that had more than g_maxLightsPerTile lights, extras are dropped
+        std::size_t shadowsRecomputed;
+        std::size_t shadowCacheHits;
+    };
+
+    class LightManager {
+        // Screen tiles a visible light touches, inclusive
+        struct tileRange {
+            int minX;
+            int minY;
+            int maxX;
+            int maxY;
+        };
+
+        std::vector<lightSource> m_lights{};
+        std::vector<bool> m_isUsed{};
+        std::vector<std::size_t> m_freeSlots{};
+        std::vector<std::size_t> m_mapLights{};
+        std::vector<float> m_lightData{};           // Four RGBA texels per visible light
+        std::vector<tileRange> m_visibleRanges{};
+        std::vector<std::uint32_t> m_tileCounts{};
+        std::vector<float> m_tileGrid{};            // One RGBA texel per tile, first index and count
+        std::vector<float> m_lightIndices{};
+        Texture2D m_lightDataTexture{};
+        Texture2D m_tileGridTexture{};
+        Texture2D m_lightIndexTexture{};
+        ShadowCaster m_shadows{};
+        std::uint64_t m_streamerPhysicsVersion{};
+        bool m_isShadowGeometryDirty{};
+        lightStats m_stats{};
+        Vector2 m_screenSize{};
+        int m_tilesX{};
+        int m_tilesY{};
+        int m_lightDataLoc{};
+        int m_lightGridLoc{};
+        int m_lightIndicesLoc{};
+        int m_shadowMaskLoc{};
+    public:
+        LightManager(const Shader& shader, int screenWidth, int screenHeight);
+        ~LightManager();
+
+        LightManager(const LightManager&) = delete;
+        LightManager(LightManager&&) = delete;
+        LightManager& operator=(const LightManager&) = delete;
+        LightManager& operator=(LightManager&&) = delete;
+
+        // Returns an id for getLight and removeLight, which stays valid until the light is removed
+        std::size_t addLight(const lightSource& light);
+        void removeLight(std::size_t id);
+        [[nodiscard]] lightSource& getLight(std::size_t id);
+
+        // Adds the lights from the map's "Lights" layer, replacing the ones from the last map
+        void setMapLights(const MapData& map);
+
+        // Rebuilds the shadow casting segments when the map or the streamer's loaded collision changed.
+        // streamer can be null.
+        void updateShadowGeometry(const MapData& map, const WorldStreamer* streamer);
+
+        // Culls, bins and uploads the lights as seen through camera. Main thread only, once per frame.
+        void update(const SceneCamera& camera, double time);
+
+        // Binds the light textures to the shader. Call after BeginShaderMode(), raylib forgets them every batch.
+        void bindTextures(const Shader& shader) const;
+
+        [[nodiscard]] const lightStats& getStats() const noexcept;
+    };
+}
+
+#endif //LIGHTMANAGER_H
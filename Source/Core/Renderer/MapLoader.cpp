@@ -0,0 +1,165 @@
+//
+// Author: DirgeWuff
+// Created on: 10/18/26
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Module purpose/description:
+//
+// Function definitions for MapLoader.h
+
+#include <algorithm>
+#include <cassert>
+#include "MapLoader.h"
+#include "../Backend/Program.h"
+#include "../Utility/Logging.h"
+
+namespace RE::Core {
+    MapLoader::MapLoader(
+        const fs::path& mapPath,
+        const b2WorldId world,
+        const std::shared_ptr<TextureAtlas>& atlas) :
+            m_atlas(atlas),
+            m_world(world),
+            m_stage(mapLoadStage::STAGING),
+            m_startTime(GetTime())
+    {
+        // The worker has m_staged to itself until the task is done
+        m_stagingTask = Program::getInstance().getScheduler().schedule([this, mapPath] {
+            m_isStaged = stageMap(mapPath, m_staged);
+        });
+
+        #ifdef DEBUG
+            logDbg("Started loading map in the background: ", mapPath.string());
+        #endif
+    }
+
+    MapLoader::~MapLoader() {
+        // Can't free anything the worker is still writing to
+        TaskScheduler::blockUntilDone(m_stagingTask);
+
+        unloadStagedMap(m_staged);
+
+        if (!m_isMapTaken && m_renderData) {
+            m_staged.mapData.renderDataPtr = m_renderData;
+            unloadMap(m_staged.mapData);
+        }
+    }
+
+    bool MapLoader::update(const double budgetSeconds) {
+        if (m_stage == mapLoadStage::DONE) return true;
+        if (m_stage == mapLoadStage::FAILED) return false;
+
+        const double frameStart = GetTime();
+        const double deadline = frameStart + budgetSeconds;
+
+        if (m_stage == mapLoadStage::STAGING) {
+            if (!TaskScheduler::isDone(m_stagingTask)) return false;
+
+            m_stagingTask = nullptr;
+
+            if (!m_isStaged) {
+                m_stage = mapLoadStage::FAILED;
+                logFatal(m_staged.error + ". MapLoader::update(Args...)");
+                return false;
+            }
+
+            #ifdef DEBUG
+                logDbg("Map staged on worker thread in ", frameStart - m_startTime, " seconds.");
+            #endif
+
+            m_renderData = std::make_shared<RenderData>();
+            m_renderData->atlas = m_atlas;
+            m_stage = mapLoadStage::UPLOADING_TEXTURES;
+        }
+
+        if (m_stage == mapLoadStage::UPLOADING_TEXTURES) {
+            if (uploadStagedTextures(m_staged, m_renderData, deadline)) {
+                resolveStagedLayers(m_staged, m_renderData);
+                m_stage = mapLoadStage::CREATING_PHYSICS;
+            }
+            else if (!m_staged.error.empty()) {
+                m_stage = mapLoadStage::FAILED;
+                logFatal(m_staged.error + ". MapLoader::update(Args...)");
+                return false;
+            }
+        }
+
+        if (m_stage == mapLoadStage::CREATING_PHYSICS && createStagedPhysics(m_staged, m_world, deadline)) {
+            m_stage = mapLoadStage::DONE;
+        }
+
+        m_mainThreadTime += GetTime() - frameStart;
+        m_frameCount++;
+
+        #ifdef DEBUG
+            if (m_stage == mapLoadStage::DONE) {
+                logDbg(
+                    "Map ready after ", GetTime() - m_startTime, " seconds. Main thread spent ",
+                    m_mainThreadTime, " seconds over ", m_frameCount, " frames.");
+            }
+        #endif
+
+        return m_stage == mapLoadStage::DONE;
+    }
+
+    [[nodiscard]] MapData MapLoader::takeMap() {
+        assert(m_stage == mapLoadStage::DONE && !m_isMapTaken);
+
+        m_isMapTaken = true;
+        m_staged.mapData.renderDataPtr = m_renderData;
+
+        #ifdef DEBUG
+            logMapMemoryStats(m_staged.mapData, m_staged);
+        #endif
+
+        return std::move(m_staged.mapData);
+    }
+
+    [[nodiscard]] float MapLoader::getProgress() const noexcept {
+        // Rough weights, decoding on the worker is the bulk of a load
+        switch (m_stage) {
+            case mapLoadStage::STAGING:
+                return 0.6f * m_staged.progress.fraction.load(std::memory_order_relaxed);
+            case mapLoadStage::UPLOADING_TEXTURES:
+                return 0.6f + 0.3f * static_cast<float>(m_staged.regions.size()) /
+                    static_cast<float>(std::max<std::size_t>(m_staged.textures.size(), 1));
+            case mapLoadStage::CREATING_PHYSICS: {
+                const std::size_t created =
+                    m_staged.mapData.collisionObjects.size() + m_staged.mapData.eventColliders.size();
+                const std::size_t total = m_staged.polylines.size() + m_staged.eventColliders.size();
+
+                return 0.9f + 0.1f * static_cast<float>(created) / static_cast<float>(std::max<std::size_t>(total, 1));
+            }
+            case mapLoadStage::DONE: return 1.0f;
+            default: return 0.0f;
+        }
+    }
+
+    [[nodiscard]] mapLoadStage MapLoader::getStage() const noexcept {
+        return m_stage;
+    }
+
+    [[nodiscard]] bool MapLoader::isBusy() const noexcept {
+        return !TaskScheduler::isDone(m_stagingTask);
+    }
+
+    void drawMapLoadProgress(const MapLoader& loader, const Rectangle bounds) {
+        const float progress = loader.getProgress();
+
+        DrawRectangleLinesEx(bounds, 2.0f, GRAY);
+        DrawRectangleRec(
+            {bounds.x + 4.0f, bounds.y + 4.0f, (bounds.width - 8.0f) * progress, bounds.height - 8.0f},
+            RED);
+
+        DrawText(
+            TextFormat("Loading map... %d%%", static_cast<int>(progress * 100.0f)),
+            static_cast<int>(bounds.x),
+            static_cast<int>(bounds.y + bounds.height + 8.0f),
+            20,
+            GRAY);
+    }
+}
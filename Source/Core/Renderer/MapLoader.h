@@ -0,0 +1,64 @@
+//
+// Author: DirgeWuff
+// Created on: 10/18/26
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Module purpose/description:
+//
+// Class declaration for MapLoader, which loads a map without stalling the
+// main thread. Parsing, image decoding and tile chunking run as a task on
+// the scheduler's workers (see StagedMap in Tilemap.h), then update() uploads textures and
+// creates the Box2D objects on the main thread a few milliseconds per frame.
+
+#ifndef MAPLOADER_H
+#define MAPLOADER_H
+
+#include <memory>
+#include "Tilemap.h"
+#include "../Backend/TaskScheduler.h"
+
+namespace RE::Core {
+    class MapLoader {
+        StagedMap m_staged{};                   // Owned by the worker until m_stagingTask is done, bar progress
+        TaskScheduler::taskHandle m_stagingTask{};
+        std::shared_ptr<RenderData> m_renderData{};
+        std::shared_ptr<TextureAtlas> m_atlas{};
+        b2WorldId m_world{};
+        mapLoadStage m_stage{};
+        double m_startTime{};
+        double m_mainThreadTime{};
+        std::size_t m_frameCount{};
+        bool m_isStaged{};                      // stageMap()'s result, set by the worker
+        bool m_isMapTaken{};
+    public:
+        MapLoader(const fs::path& mapPath, b2WorldId world, const std::shared_ptr<TextureAtlas>& atlas);
+        ~MapLoader();
+
+        MapLoader(const MapLoader&) = delete;
+        MapLoader(MapLoader&&) = delete;
+        MapLoader& operator=(const MapLoader&) = delete;
+        MapLoader& operator=(MapLoader&&) = delete;
+
+        // Moves the load along for at most budgetSeconds. Main thread only, call once per frame.
+        // Returns true once the map is ready to be taken. Failures are logged fatally.
+        bool update(double budgetSeconds);
+
+        // Hands over the finished map. Only valid once update() has returned true, and only once.
+        [[nodiscard]] MapData takeMap();
+
+        [[nodiscard]] float getProgress() const noexcept;
+        [[nodiscard]] mapLoadStage getStage() const noexcept;
+
+        // True while the worker is still staging the map. Destroying the loader until then blocks on it.
+        [[nodiscard]] bool isBusy() const noexcept;
+    };
+
+    // Progress bar with a percentage underneath, for whichever layer is on screen during the load
+    void drawMapLoadProgress(const MapLoader& loader, Rectangle bounds);
+}
+
+#endif //MAPLOADER_H
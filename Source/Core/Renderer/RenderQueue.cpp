@@ -0,0 +1,158 @@
+//
+// Author: DirgeWuff
+// Created on: 10/18/26
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Module purpose/description:
+//
+// Function definitions for RenderQueue.h
+
+#include <algorithm>
+#include <cmath>
+#include "rlgl.h"
+#include "RenderQueue.h"
+
+namespace RE::Core {
+    // Pass in the top 4 bits, then 16 of depth, 12 of shader id and 32 of texture id
+    std::uint64_t RenderQueue::makeKey(
+        const drawPass pass,
+        const std::uint16_t depth,
+        const Shader* shader,
+        const Texture2D& texture)
+    {
+        const std::uint64_t shaderId = shader ? shader->id & 0xFFF : 0;
+
+        return static_cast<std::uint64_t>(pass) << 60 |
+            static_cast<std::uint64_t>(depth) << 44 |
+            shaderId << 32 |
+            texture.id;
+    }
+
+    void RenderQueue::drawTexture(
+        const drawPass pass,
+        const std::uint16_t depth,
+        const Texture2D& texture,
+        const Rectangle source,
+        const Vector2 position,
+        const Color tint,
+        const Shader* shader,
+        const BlendMode blendMode)
+    {
+        m_commands.push_back({
+            makeKey(pass, depth, shader, texture),
+            &texture,
+            shader,
+            source,
+            {position.x, position.y, std::abs(source.width), std::abs(source.height)},
+            tint,
+            nullptr,
+            0,
+            blendMode});
+    }
+
+    void RenderQueue::drawQuads(
+        const drawPass pass,
+        const std::uint16_t depth,
+        const Texture2D& texture,
+        const tileVertex* vertices,
+        const std::uint32_t quadCount,
+        const Vector2 offset,
+        const Color tint)
+    {
+        if (quadCount == 0) return;
+
+        m_commands.push_back({
+            makeKey(pass, depth, nullptr, texture),
+            &texture,
+            nullptr,
+            {},
+            {offset.x, offset.y, 0.0f, 0.0f},
+            tint,
+            vertices,
+            quadCount,
+            BLEND_ALPHA});
+    }
+
+    void RenderQueue::append(RenderQueue& other) {
+        m_commands.insert(m_commands.end(), other.m_commands.begin(), other.m_commands.end());
+        other.m_commands.clear();
+    }
+
+    void RenderQueue::flush() {
+        if (m_commands.empty()) return;
+
+        std::ranges::stable_sort(m_commands, {}, &renderCommand::key);
+
+        const Shader* currentShader = nullptr;
+        unsigned int currentTexture = 0;
+        BlendMode currentBlendMode = BLEND_ALPHA;
+
+        for (const auto& command : m_commands) {
+            const unsigned int shaderId = command.shader ? command.shader->id : 0;
+            const unsigned int currentShaderId = currentShader ? currentShader->id : 0;
+            const bool isShaderChange = shaderId != currentShaderId;
+            const bool isTextureChange = command.texture->id != currentTexture;
+            const bool isBlendModeChange = command.blendMode != currentBlendMode;
+
+            if (isShaderChange) {
+                if (currentShader) EndShaderMode();
+                if (command.shader) BeginShaderMode(*command.shader);
+
+                currentShader = command.shader;
+                m_stats.shaderChanges++;
+            }
+
+            if (isTextureChange) {
+                currentTexture = command.texture->id;
+                m_stats.textureChanges++;
+            }
+
+            // Blend modes come with the texture, so they don't need a place in the key
+            if (isBlendModeChange) {
+                BeginBlendMode(command.blendMode);
+                currentBlendMode = command.blendMode;
+            }
+
+            if (isShaderChange || isTextureChange || isBlendModeChange) m_stats.drawCalls++;
+
+            if (!command.vertices) {
+                DrawTexturePro(*command.texture, command.source, command.dest, {0.0f, 0.0f}, 0.0f, command.tint);
+                continue;
+            }
+
+            rlPushMatrix();
+            rlTranslatef(command.dest.x, command.dest.y, 0.0f);
+            rlSetTexture(command.texture->id);
+            rlBegin(RL_QUADS);
+            rlColor4ub(command.tint.r, command.tint.g, command.tint.b, command.tint.a);
+            rlNormal3f(0.0f, 0.0f, 1.0f);
+
+            for (std::uint32_t v = 0; v < command.quadCount * 4; v++) {
+                rlTexCoord2f(command.vertices[v].u, command.vertices[v].v);
+                rlVertex2f(command.vertices[v].x, command.vertices[v].y);
+            }
+
+            rlEnd();
+            rlSetTexture(0);
+            rlPopMatrix();
+        }
+
+        if (currentShader) EndShaderMode();
+        if (currentBlendMode != BLEND_ALPHA) EndBlendMode();
+
+        m_stats.commands += m_commands.size();
+        m_commands.clear();
+    }
+
+    void RenderQueue::resetStats() noexcept {
+        m_stats = {};
+    }
+
+    [[nodiscard]] const renderQueueStats& RenderQueue::getStats() const noexcept {
+        return m_stats;
+    }
+}
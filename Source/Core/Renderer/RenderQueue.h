@@ -0,0 +1,92 @@
+//
+// Author: DirgeWuff
+// Created on: 10/18/26
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Module purpose/description:
+//
+// Class declaration for RenderQueue. Map layers and entities record their
+// textured draws here instead of calling raylib, each with a sort key made
+// of its drawPass, its depth inside the pass, its shader and its texture.
+// flush() sorts by that key and submits, so draws that can't overlap one
+// another end up grouped by shader and texture, and rlgl only has to break
+// its batch when one of them actually changes. Draws with equal keys keep
+// the order they were recorded in.
+
+#ifndef RENDERQUEUE_H
+#define RENDERQUEUE_H
+
+#include <cstdint>
+#include <vector>
+#include "raylib.h"
+#include "Tilemap.h"
+#include "../Utility/Enum.h"
+
+namespace RE::Core {
+    struct renderQueueStats {
+        std::size_t commands;
+        std::size_t drawCalls;      // One per run of commands sharing a shader and texture, like rlgl's batches
+        std::size_t textureChanges;
+        std::size_t shaderChanges;
+    };
+
+    class RenderQueue {
+        struct renderCommand {
+            std::uint64_t key;
+            const Texture2D* texture;
+            const Shader* shader;           // Null for raylib's default
+            Rectangle source;
+            Rectangle dest;                 // Only x and y are used for quads, as their offset
+            Color tint;
+            const tileVertex* vertices;     // Prebuilt quads, drawn instead of source and dest when set
+            std::uint32_t quadCount;
+            BlendMode blendMode;
+        };
+
+        std::vector<renderCommand> m_commands{};
+        renderQueueStats m_stats{};
+
+        static std::uint64_t makeKey(
+            drawPass pass,
+            std::uint16_t depth,
+            const Shader* shader,
+            const Texture2D& texture);
+    public:
+        // Everything passed by reference or pointer has to stay alive until flush().
+        // Textures with premultiplied alpha, like baked render targets, take BLEND_ALPHA_PREMULTIPLY.
+        void drawTexture(
+            drawPass pass,
+            std::uint16_t depth,
+            const Texture2D& texture,
+            Rectangle source,
+            Vector2 position,
+            Color tint,
+            const Shader* shader = nullptr,
+            BlendMode blendMode = BLEND_ALPHA);
+
+        void drawQuads(
+            drawPass pass,
+            std::uint16_t depth,
+            const Texture2D& texture,
+            const tileVertex* vertices,
+            std::uint32_t quadCount,
+            Vector2 offset,
+            Color tint);
+
+        // Moves other's commands to the end of this queue, as if they had been recorded here.
+        // Lets worker threads record into their own queues and the main thread merge them in a fixed order.
+        void append(RenderQueue& other);
+
+        // Sorts and draws everything recorded since the last flush, with whatever camera and target are active
+        void flush();
+
+        void resetStats() noexcept;
+        [[nodiscard]] const renderQueueStats& getStats() const noexcept;
+    };
+}
+
+#endif //RENDERQUEUE_H
@@ -0,0 +1,153 @@
+//
+// Author: DirgeWuff
+// Created on: 10/18/26
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Module purpose/description:
+//
+// Function definitions for ResolutionScaler.h
+
+#include <algorithm>
+#include <cmath>
+#include "ResolutionScaler.h"
+#include "../Utility/Enum.h"
+#include "../Utility/Globals.h"
+#include "../Utility/Logging.h"
+
+namespace RE::Core {
+    ResolutionScaler::ResolutionScaler(const int width, const int height) :
+        m_width(width),
+        m_height(height)
+    {
+        m_target = LoadRenderTexture(m_width, m_height);
+        m_sharpBilinearShader = LoadShader(NULL, "../assets/Shaders/sharpBilinear.fsh"); // NOLINT
+
+        if (!IsShaderValid(m_sharpBilinearShader)) {
+            logFatal("Unable to load shader. ResolutionScaler::ResolutionScaler(Args...)");
+            return;
+        }
+
+        m_textureSizeLoc = GetShaderLocation(m_sharpBilinearShader, "textureSize");
+        m_outputScaleLoc = GetShaderLocation(m_sharpBilinearShader, "outputScale");
+
+        const Vector2 size = getSize();
+        SetShaderValue(m_sharpBilinearShader, m_textureSizeLoc, &size, SHADER_UNIFORM_VEC2);
+
+        #ifdef DEBUG
+            logDbg(
+                "Rendering at ",
+                m_width,
+                "x",
+                m_height,
+                ", scaled with ",
+                upscaleFilterToStr(toEnum<upscaleFilter>(g_upscaleFilter).value_or(upscaleFilter::SHARP_BILINEAR)));
+        #endif
+    }
+
+    ResolutionScaler::~ResolutionScaler() {
+        UnloadShader(m_sharpBilinearShader);
+        UnloadRenderTexture(m_target);
+    }
+
+    // Window pixels per pixel of the full target, the render scale doesn't change the size on screen
+    [[nodiscard]] float ResolutionScaler::getTargetScale(const int filter) const noexcept {
+        const float scale = std::min(
+            static_cast<float>(GetScreenWidth()) / static_cast<float>(m_width),
+            static_cast<float>(GetScreenHeight()) / static_cast<float>(m_height));
+
+        if (toEnum<upscaleFilter>(filter) == upscaleFilter::INTEGER) return std::max(std::floor(scale), 1.0f);
+
+        return scale;
+    }
+
+    [[nodiscard]] Rectangle ResolutionScaler::getOutputRect(const int filter) const noexcept {
+        const float scale = getTargetScale(filter);
+        const float width = static_cast<float>(m_width) * scale;
+        const float height = static_cast<float>(m_height) * scale;
+
+        // Centered, whatever doesn't fit the window's aspect ratio is left black
+        return {
+            std::floor((static_cast<float>(GetScreenWidth()) - width) / 2.0f),
+            std::floor((static_cast<float>(GetScreenHeight()) - height) / 2.0f),
+            width,
+            height};
+    }
+
+    void ResolutionScaler::begin() const {
+        BeginTextureMode(m_target);
+        ClearBackground(BLACK);
+    }
+
+    void ResolutionScaler::end() const {
+        EndTextureMode();
+    }
+
+    void ResolutionScaler::draw() {
+        const bool isSharpBilinear = toEnum<upscaleFilter>(g_upscaleFilter) == upscaleFilter::SHARP_BILINEAR;
+
+        // Sharp bilinear does its own blending between texels, so it needs the hardware to filter
+        if (m_currentFilter != g_upscaleFilter) {
+            SetTextureFilter(m_target.texture, isSharpBilinear ? TEXTURE_FILTER_BILINEAR : TEXTURE_FILTER_POINT);
+            m_currentFilter = g_upscaleFilter;
+        }
+
+        ClearBackground(BLACK);
+
+        if (isSharpBilinear) {
+            const float scale = getOutputScale();
+
+            BeginShaderMode(m_sharpBilinearShader);
+            SetShaderValue(m_sharpBilinearShader, m_outputScaleLoc, &scale, SHADER_UNIFORM_FLOAT);
+        }
+
+        DrawTexturePro(
+            m_target.texture,
+            getRenderSource(),
+            getOutputRect(g_upscaleFilter),
+            {0.0f, 0.0f},
+            0.0f,
+            WHITE);
+
+        if (isSharpBilinear) EndShaderMode();
+    }
+
+    void ResolutionScaler::setRenderScale(const float scale) noexcept {
+        m_renderScale = scale;
+    }
+
+    [[nodiscard]] float ResolutionScaler::getRenderScale() const noexcept {
+        return m_renderScale;
+    }
+
+    [[nodiscard]] float ResolutionScaler::getOutputScale() const noexcept {
+        return getOutputRect(g_upscaleFilter).width / getRenderSize().x;
+    }
+
+    [[nodiscard]] Vector2 ResolutionScaler::toInternal(const Vector2 windowPosition) const noexcept {
+        const Rectangle output = getOutputRect(g_upscaleFilter);
+        const float scale = getOutputScale();
+
+        return {(windowPosition.x - output.x) / scale, (windowPosition.y - output.y) / scale};
+    }
+
+    [[nodiscard]] Vector2 ResolutionScaler::getSize() const noexcept {
+        return {static_cast<float>(m_width), static_cast<float>(m_height)};
+    }
+
+    [[nodiscard]] Vector2 ResolutionScaler::getRenderSize() const noexcept {
+        return {
+            std::round(static_cast<float>(m_width) * m_renderScale),
+            std::round(static_cast<float>(m_height) * m_renderScale)};
+    }
+
+    [[nodiscard]] Rectangle ResolutionScaler::getRenderSource() const noexcept {
+        const Vector2 renderSize = getRenderSize();
+
+        // Render textures are upside down, so the top left of what was drawn is at the bottom of the texture
+        return {0.0f, static_cast<float>(m_height) - renderSize.y, renderSize.x, -renderSize.y};
+    }
+}
@@ -0,0 +1,71 @@
+//
+// Author: DirgeWuff
+// Created on: 10/18/26
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Module purpose/description:
+//
+// Class declaration for ResolutionScaler, the low resolution target the
+// world is drawn into at the art's own pixel density. Every pass, lighting
+// included, runs at that size, and draw() scales the finished frame up to
+// the window with the filter picked by g_upscaleFilter. UI is drawn to the
+// window afterwards, at full resolution. With a render scale below 1 only the
+// top left of the target is drawn into, see DynamicResolution, so changing it
+// never reallocates anything.
+
+#ifndef RESOLUTIONSCALER_H
+#define RESOLUTIONSCALER_H
+
+#include "raylib.h"
+
+namespace RE::Core {
+    class ResolutionScaler {
+        RenderTexture2D m_target{};
+        Shader m_sharpBilinearShader{};
+        int m_textureSizeLoc{};
+        int m_outputScaleLoc{};
+        int m_width{};
+        int m_height{};
+        int m_currentFilter{-1};    // Underlying value of upscaleFilter the texture is set up for
+        float m_renderScale{1.0f};
+
+        [[nodiscard]] float getTargetScale(int filter) const noexcept;
+        [[nodiscard]] Rectangle getOutputRect(int filter) const noexcept;
+    public:
+        ResolutionScaler(int width, int height);
+        ~ResolutionScaler();
+
+        ResolutionScaler(const ResolutionScaler&) = delete;
+        ResolutionScaler(ResolutionScaler&&) = delete;
+        ResolutionScaler& operator=(const ResolutionScaler&) = delete;
+        ResolutionScaler& operator=(ResolutionScaler&&) = delete;
+
+        void begin() const;
+        void end() const;
+
+        // Scales the frame up to the window, outside of any texture mode
+        void draw();
+
+        void setRenderScale(float scale) noexcept;
+        [[nodiscard]] float getRenderScale() const noexcept;
+
+        // Window pixels per drawn pixel
+        [[nodiscard]] float getOutputScale() const noexcept;
+
+        // Maps a window position, like the mouse's, onto the drawn part of the frame
+        [[nodiscard]] Vector2 toInternal(Vector2 windowPosition) const noexcept;
+
+        // Full size of the target, and the part of it drawn into at the current render scale
+        [[nodiscard]] Vector2 getSize() const noexcept;
+        [[nodiscard]] Vector2 getRenderSize() const noexcept;
+
+        // Flipped source rectangle for drawing the drawn part of a target this size
+        [[nodiscard]] Rectangle getRenderSource() const noexcept;
+    };
+}
+
+#endif //RESOLUTIONSCALER_H
@@ -0,0 +1,335 @@
+//
+// Author: DirgeWuff
+// Created on: 10/18/26
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Module purpose/description:
+//
+// Function definitions for ShadowCaster.h
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include "rlgl.h"
+#include "ShadowCaster.h"
+#include "../Utility/Globals.h"
+
+namespace RE::Core {
+    static constexpr std::size_t g_noCellOwner = SIZE_MAX;
+    static constexpr int g_cellsPerRow = g_shadowAtlasSize / g_shadowCellSize;
+
+    static std::uint64_t getGridKey(const int x, const int y) {
+        return static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 32 | static_cast<std::uint32_t>(y);
+    }
+
+    static int getGridCoord(const float positionPx) {
+        return static_cast<int>(std::floor(positionPx / g_shadowGridCellSize));
+    }
+
+    static std::uint64_t hashSegment(const shadowSegment& segment) {
+        std::uint64_t hash = 14695981039346656037ull;
+
+        for (const float value : {segment.a.x, segment.a.y, segment.b.x, segment.b.y}) {
+            hash = (hash ^ std::bit_cast<std::uint32_t>(value)) * 1099511628211ull;
+        }
+
+        return hash;
+    }
+
+    static float cross(const Vector2 a, const Vector2 b) {
+        return a.x * b.y - a.y * b.x;
+    }
+
+    ShadowCaster::ShadowCaster() :
+        m_cellOwners(static_cast<std::size_t>(g_cellsPerRow) * g_cellsPerRow, g_noCellOwner)
+    {
+        m_atlas = LoadRenderTexture(g_shadowAtlasSize, g_shadowAtlasSize);
+        SetTextureFilter(m_atlas.texture, TEXTURE_FILTER_BILINEAR);
+
+        BeginTextureMode(m_atlas);
+            ClearBackground(BLACK);
+        EndTextureMode();
+    }
+
+    ShadowCaster::~ShadowCaster() {
+        UnloadRenderTexture(m_atlas);
+    }
+
+    std::uint64_t ShadowCaster::querySegments(const Vector2 position, const float radius) {
+        m_candidates.clear();
+        m_queryStamp++;
+
+        if (m_queryStamp == 0) {
+            std::ranges::fill(m_queryStamps, 0u);
+            m_queryStamp = 1;
+        }
+
+        // Sum of segment hashes, so the order the grid hands them back in doesn't matter
+        std::uint64_t hash = 0;
+
+        for (int y = getGridCoord(position.y - radius); y <= getGridCoord(position.y + radius); y++) {
+            for (int x = getGridCoord(position.x - radius); x <= getGridCoord(position.x + radius); x++) {
+                const auto it = m_grid.find(getGridKey(x, y));
+                if (it == m_grid.end()) continue;
+
+                for (const std::uint32_t index : it->second) {
+                    if (m_queryStamps[index] == m_queryStamp) continue;
+
+                    m_queryStamps[index] = m_queryStamp;
+                    m_candidates.push_back(index);
+                    hash += hashSegment(m_segments[index]);
+                }
+            }
+        }
+
+        return hash;
+    }
+
+    void ShadowCaster::computeVisibility(const Vector2 position, const float radius, std::vector<Vector2>& polygon) {
+        constexpr float angleOffset = 0.0001f;
+
+        m_rayAngles.clear();
+
+        const auto addRays = [this, position](const Vector2 point) {
+            const float angle = std::atan2(point.y - position.y, point.x - position.x);
+            m_rayAngles.insert(m_rayAngles.end(), {angle - angleOffset, angle, angle + angleOffset});
+        };
+
+        // Corners of the light's square, so there's always something to hit
+        addRays({position.x - radius, position.y - radius});
+        addRays({position.x + radius, position.y - radius});
+        addRays({position.x + radius, position.y + radius});
+        addRays({position.x - radius, position.y + radius});
+
+        for (const std::uint32_t index : m_candidates) {
+            addRays(m_segments[index].a);
+            addRays(m_segments[index].b);
+        }
+
+        std::ranges::sort(m_rayAngles);
+
+        polygon.clear();
+        polygon.reserve(m_rayAngles.size());
+
+        for (const float angle : m_rayAngles) {
+            const Vector2 direction = {std::cos(angle), std::sin(angle)};
+
+            // Distance to the edge of the square
+            float nearest = radius / std::max(std::abs(direction.x), std::abs(direction.y));
+
+            for (const std::uint32_t index : m_candidates) {
+                const shadowSegment& segment = m_segments[index];
+                const Vector2 edge = {segment.b.x - segment.a.x, segment.b.y - segment.a.y};
+                const Vector2 toStart = {segment.a.x - position.x, segment.a.y - position.y};
+                const float denominator = cross(direction, edge);
+
+                if (std::abs(denominator) < 1e-6f) continue;
+
+                const float t = cross(toStart, edge) / denominator;
+                const float u = cross(toStart, direction) / denominator;
+
+                if (t >= 0.0f && t < nearest && u >= 0.0f && u <= 1.0f) nearest = t;
+            }
+
+            polygon.push_back({position.x + direction.x * nearest, position.y + direction.y * nearest});
+        }
+    }
+
+    [[nodiscard]] int ShadowCaster::allocateCell(const std::size_t lightId) {
+        int best = -1;
+        std::uint64_t bestFrame = m_frame;
+
+        for (std::size_t i = 0; i < m_cellOwners.size(); i++) {
+            if (m_cellOwners[i] == g_noCellOwner) {
+                best = static_cast<int>(i);
+                break;
+            }
+
+            // Otherwise take the cell that's gone unused the longest, never one already used this frame
+            const std::uint64_t lastUsed = m_cache.at(m_cellOwners[i]).lastUsedFrame;
+            if (lastUsed < bestFrame) {
+                best = static_cast<int>(i);
+                bestFrame = lastUsed;
+            }
+        }
+
+        if (best < 0) return -1;
+
+        if (m_cellOwners[best] != g_noCellOwner) {
+            cacheEntry& evicted = m_cache.at(m_cellOwners[best]);
+            evicted.cell = -1;
+            evicted.radius = -1.0f; // Forces a rebuild if the light comes back
+        }
+
+        m_cellOwners[best] = lightId;
+
+        return best;
+    }
+
+    [[nodiscard]] shadowCell ShadowCaster::getCellCoords(const int cell) const noexcept {
+        constexpr auto atlasSize = static_cast<float>(g_shadowAtlasSize);
+        constexpr auto cellSize = static_cast<float>(g_shadowCellSize);
+
+        const auto cellX = static_cast<float>(cell % g_cellsPerRow);
+        const auto cellY = static_cast<float>(cell / g_cellsPerRow);
+
+        // Render textures are upside down, a texel drawn at y ends up at v = 1 - y
+        return {
+            {(cellX + 0.5f) * cellSize / atlasSize, 1.0f - (cellY + 0.5f) * cellSize / atlasSize},
+            (cellSize * 0.5f - 1.0f) / atlasSize,
+            true};
+    }
+
+    void ShadowCaster::clearGeometry() {
+        m_segments.clear();
+        m_grid.clear();
+    }
+
+    void ShadowCaster::addGeometry(const CollisionStore& splines) {
+        for (const auto& spline : splines.getSplines()) {
+            const std::span<const b2Vec2> verts = splines.getVerts(spline);
+
+            for (std::size_t i = 1; i < verts.size(); i++) {
+                m_segments.push_back({metersToPixelsVec(verts[i - 1]), metersToPixelsVec(verts[i])});
+            }
+        }
+    }
+
+    void ShadowCaster::finishGeometry() {
+        for (std::uint32_t i = 0; i < m_segments.size(); i++) {
+            const shadowSegment& segment = m_segments[i];
+
+            for (int y = getGridCoord(std::min(segment.a.y, segment.b.y));
+                y <= getGridCoord(std::max(segment.a.y, segment.b.y)); y++)
+            {
+                for (int x = getGridCoord(std::min(segment.a.x, segment.b.x));
+                    x <= getGridCoord(std::max(segment.a.x, segment.b.x)); x++)
+                {
+                    m_grid[getGridKey(x, y)].push_back(i);
+                }
+            }
+        }
+
+        m_queryStamps.assign(m_segments.size(), 0);
+        m_queryStamp = 0;
+    }
+
+    void ShadowCaster::beginFrame() {
+        m_frame++;
+        m_recomputedThisFrame = 0;
+        m_cacheHitsThisFrame = 0;
+    }
+
+    [[nodiscard]] shadowCell ShadowCaster::getShadow(
+        const std::size_t lightId,
+        const Vector2 position,
+        const float radius)
+    {
+        const std::uint64_t segmentHash = querySegments(position, radius);
+        const auto it = m_cache.find(lightId);
+
+        if (it != m_cache.end()) {
+            const cacheEntry& entry = it->second;
+            const float moved = std::hypot(position.x - entry.position.x, position.y - entry.position.y);
+
+            if (moved <= g_shadowMoveTolerance && entry.radius == radius && entry.segmentHash == segmentHash) {
+                it->second.lastUsedFrame = m_frame;
+                m_cacheHitsThisFrame++;
+
+                return entry.cell < 0 ? shadowCell{} : getCellCoords(entry.cell);
+            }
+        }
+
+        cacheEntry& entry = it != m_cache.end()
+            ? it->second
+            : m_cache.emplace(lightId, cacheEntry{{}, 0.0f, 0, 0, -1}).first->second;
+        entry.position = position;
+        entry.radius = radius;
+        entry.segmentHash = segmentHash;
+        entry.lastUsedFrame = m_frame;
+
+        // Nothing to cast shadows, so the light doesn't need a cell at all
+        if (m_candidates.empty()) {
+            if (entry.cell >= 0) m_cellOwners[entry.cell] = g_noCellOwner;
+            entry.cell = -1;
+
+            return {};
+        }
+
+        if (entry.cell < 0) {
+            entry.cell = allocateCell(lightId);
+
+            // Atlas is full of lights on screen, try again next frame
+            if (entry.cell < 0) {
+                entry.radius = -1.0f;
+                return {};
+            }
+        }
+
+        m_recomputedThisFrame++;
+
+        pendingCell& pending = m_pendingCells.emplace_back();
+        pending.cell = entry.cell;
+        pending.position = position;
+        pending.radius = radius;
+        computeVisibility(position, radius, pending.polygon);
+
+        return getCellCoords(entry.cell);
+    }
+
+    void ShadowCaster::forgetLight(const std::size_t lightId) {
+        const auto it = m_cache.find(lightId);
+        if (it == m_cache.end()) return;
+
+        if (it->second.cell >= 0) m_cellOwners[it->second.cell] = g_noCellOwner;
+        m_cache.erase(it);
+    }
+
+    void ShadowCaster::drawPendingCells() {
+        if (m_pendingCells.empty()) return;
+
+        constexpr auto cellSize = static_cast<float>(g_shadowCellSize);
+
+        BeginTextureMode(m_atlas);
+        rlDisableBackfaceCulling(); // Fans can wind either way
+
+        for (const auto& [cell, position, radius, polygon] : m_pendingCells) {
+            const Vector2 origin = {
+                static_cast<float>(cell % g_cellsPerRow) * cellSize,
+                static_cast<float>(cell / g_cellsPerRow) * cellSize};
+            const Vector2 center = {origin.x + cellSize * 0.5f, origin.y + cellSize * 0.5f};
+            const float scale = (cellSize * 0.5f - 1.0f) / radius;
+
+            const auto toCell = [&center, &position, scale](const Vector2 point) {
+                return Vector2{center.x + (point.x - position.x) * scale, center.y + (point.y - position.y) * scale};
+            };
+
+            DrawRectangleV(origin, {cellSize, cellSize}, BLACK);
+
+            for (std::size_t i = 0; i < polygon.size(); i++) {
+                DrawTriangle(center, toCell(polygon[i]), toCell(polygon[(i + 1) % polygon.size()]), WHITE);
+            }
+        }
+
+        rlEnableBackfaceCulling();
+        EndTextureMode();
+
+        m_pendingCells.clear();
+    }
+
+    [[nodiscard]] const Texture2D& ShadowCaster::getMaskTexture() const noexcept {
+        return m_atlas.texture;
+    }
+
+    [[nodiscard]] std::size_t ShadowCaster::getRecomputedCount() const noexcept {
+        return m_recomputedThisFrame;
+    }
+
+    [[nodiscard]] std::size_t ShadowCaster::getCacheHitCount() const noexcept {
+        return m_cacheHitsThisFrame;
+    }
+}
@@ -0,0 +1,106 @@
+//
+// Author: DirgeWuff
+// Created on: 10/18/26
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Module purpose/description:
+//
+// Class declaration for ShadowCaster, which works out what each light can see
+// past the map's collision chains and draws it into a mask the lighting shader
+// samples. Chain segments are kept in a uniform grid, so a light only tests the
+// segments within its radius. Each shadowed light gets a square cell in a mask
+// atlas, covering its radius in world space, holding its visibility polygon.
+// Cells are kept between frames and only redrawn when the light moves or the
+// segments around it change, so static lights cost one grid query per frame.
+
+#ifndef SHADOWCASTER_H
+#define SHADOWCASTER_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "raylib.h"
+#include "Tilemap.h"
+
+namespace RE::Core {
+    struct shadowSegment {
+        Vector2 a;
+        Vector2 b;
+    };
+
+    // Where a light's mask is in the atlas, in texture coordinates, ready to hand to the shader
+    struct shadowCell {
+        Vector2 centerUv;
+        float halfSizeUv;   // Light radius in texture coordinates
+        bool hasShadow;     // False when nothing near the light casts shadows, or the atlas is full
+    };
+
+    class ShadowCaster {
+        struct cacheEntry {
+            Vector2 position;
+            float radius;
+            std::uint64_t segmentHash;  // Order independent, so rebuilding the grid doesn't invalidate it
+            std::uint64_t lastUsedFrame;
+            int cell;                   // -1 when the light has no shadows
+        };
+
+        struct pendingCell {
+            int cell;
+            Vector2 position;
+            float radius;
+            std::vector<Vector2> polygon;   // Fan around position, in world pixels
+        };
+
+        std::vector<shadowSegment> m_segments{};
+        std::unordered_map<std::uint64_t, std::vector<std::uint32_t>> m_grid{};
+        std::vector<std::uint32_t> m_queryStamps{};     // Per segment, so a query returns each segment once
+        std::uint32_t m_queryStamp{};
+        std::vector<std::uint32_t> m_candidates{};
+        std::vector<float> m_rayAngles{};
+        std::unordered_map<std::size_t, cacheEntry> m_cache{};     // By light id
+        std::vector<std::size_t> m_cellOwners{};                    // Light id per cell, SIZE_MAX when free
+        std::vector<pendingCell> m_pendingCells{};
+        RenderTexture2D m_atlas{};
+        std::uint64_t m_frame{};
+        std::size_t m_recomputedThisFrame{};
+        std::size_t m_cacheHitsThisFrame{};
+
+        std::uint64_t querySegments(Vector2 position, float radius);
+        void computeVisibility(Vector2 position, float radius, std::vector<Vector2>& polygon);
+        [[nodiscard]] int allocateCell(std::size_t lightId);
+        [[nodiscard]] shadowCell getCellCoords(int cell) const noexcept;
+    public:
+        ShadowCaster();
+        ~ShadowCaster();
+
+        ShadowCaster(const ShadowCaster&) = delete;
+        ShadowCaster(ShadowCaster&&) = delete;
+        ShadowCaster& operator=(const ShadowCaster&) = delete;
+        ShadowCaster& operator=(ShadowCaster&&) = delete;
+
+        // Replaces the shadow casting geometry. Cached cells survive as long as the segments near them are the same.
+        void clearGeometry();
+        void addGeometry(const CollisionStore& splines);
+        void finishGeometry();
+
+        // Starts a new frame, cells not used in the last frame can be given to other lights
+        void beginFrame();
+
+        // Finds or builds the mask for a light. A changed mask isn't drawn until drawPendingCells().
+        [[nodiscard]] shadowCell getShadow(std::size_t lightId, Vector2 position, float radius);
+        void forgetLight(std::size_t lightId);
+
+        // Draws every mask that changed this frame into the atlas. Main thread, outside any other texture mode.
+        void drawPendingCells();
+
+        [[nodiscard]] const Texture2D& getMaskTexture() const noexcept;
+        [[nodiscard]] std::size_t getRecomputedCount() const noexcept;
+        [[nodiscard]] std::size_t getCacheHitCount() const noexcept;
+    };
+}
+
+#endif //SHADOWCASTER_H
@@ -0,0 +1,156 @@
+//
+// Author: DirgeWuff
+// Created on: 10/18/26
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Module purpose/description:
+//
+// Function definitions for TextureAtlas.h
+
+#include "TextureAtlas.h"
+#include "../Utility/Globals.h"
+#include "../Utility/Logging.h"
+
+namespace RE::Core {
+    TextureAtlas::TextureAtlas() {
+        #ifdef DEBUG
+            logDbg("TextureAtlas constructed at address: ", this);
+        #endif
+    }
+
+    TextureAtlas::~TextureAtlas() {
+        for (const auto& page : m_pages) {
+            if (IsTextureValid(page.texture)) UnloadTexture(page.texture);
+        }
+
+        #ifdef DEBUG
+            logDbg("TextureAtlas destroyed at address: ", this);
+        #endif
+    }
+
+    [[nodiscard]] bool packIntoShelf(
+        atlasShelf& shelf,
+        const int pageSize,
+        const int width,
+        const int height,
+        Vector2& position)
+    {
+        const int paddedWidth = width + g_atlasPadding;
+        const int paddedHeight = height + g_atlasPadding;
+
+        // Fits at the end of the current shelf
+        if (shelf.cursorX + paddedWidth <= pageSize &&
+            shelf.shelfY + paddedHeight <= pageSize &&
+            paddedHeight <= shelf.shelfHeight)
+        {
+            position = {static_cast<float>(shelf.cursorX), static_cast<float>(shelf.shelfY)};
+            shelf.cursorX += paddedWidth;
+            return true;
+        }
+
+        // Fits on a new shelf
+        const int nextShelfY = shelf.shelfY + shelf.shelfHeight;
+        if (paddedWidth <= pageSize && nextShelfY + paddedHeight <= pageSize) {
+            shelf = {paddedWidth, nextShelfY, paddedHeight};
+            position = {0.0f, static_cast<float>(nextShelfY)};
+            return true;
+        }
+
+        return false;
+    }
+
+    // Pages fill up front to back, so only the last page can have room for anything
+    atlasPage* TextureAtlas::findSpace(const int width, const int height, Vector2& position) {
+        if (!m_pages.empty() && packIntoShelf(m_pages.back().shelf, g_atlasPageSize, width, height, position)) {
+            return &m_pages.back();
+        }
+
+        // Start a fresh page, cleared so padding never samples garbage
+        const Image blank = GenImageColor(g_atlasPageSize, g_atlasPageSize, BLANK);
+        const Texture2D pageTexture = LoadTextureFromImage(blank);
+        UnloadImage(blank);
+
+        if (!IsTextureValid(pageTexture)) {
+            logFatal("Unable to create texture atlas page: TextureAtlas::findSpace(Args...)");
+            return nullptr;
+        }
+
+        m_pages.push_back({pageTexture, {}});
+        if (!packIntoShelf(m_pages.back().shelf, g_atlasPageSize, width, height, position)) return nullptr;
+
+        return &m_pages.back();
+    }
+
+    const atlasRegion* TextureAtlas::addImage(const std::string& imagePath) {
+        if (const auto it = m_regions.find(imagePath); it != m_regions.end()) {
+            return &it->second;
+        }
+
+        const Image image = LoadImage(imagePath.c_str());
+
+        if (!IsImageValid(image)) {
+            logFatal("Unable to load image: " + imagePath + ": TextureAtlas::addImage(Args...)");
+            return nullptr;
+        }
+
+        const atlasRegion* region = addImage(imagePath, image);
+        UnloadImage(image);
+
+        return region;
+    }
+
+    const atlasRegion* TextureAtlas::addImage(const std::string& imagePath, const Image& image) {
+        if (const auto it = m_regions.find(imagePath); it != m_regions.end()) {
+            return &it->second;
+        }
+
+        if (image.width > g_atlasMaxImageSize || image.height > g_atlasMaxImageSize) {
+            return nullptr;
+        }
+
+        // Pages are RGBA8, images decoded off the main thread normally arrive converted already
+        Image converted = image;
+        if (image.format != PIXELFORMAT_UNCOMPRESSED_R8G8B8A8) {
+            converted = ImageCopy(image);
+            ImageFormat(&converted, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+        }
+
+        Vector2 position{};
+        atlasPage* page = findSpace(converted.width, converted.height, position);
+
+        if (!page) {
+            if (converted.data != image.data) UnloadImage(converted);
+            return nullptr;
+        }
+
+        const Rectangle rect = {
+            position.x,
+            position.y,
+            static_cast<float>(converted.width),
+            static_cast<float>(converted.height)};
+
+        UpdateTextureRec(page->texture, rect, converted.data);
+        if (converted.data != image.data) UnloadImage(converted);
+
+        #ifdef DEBUG
+            logDbg("Packed " + imagePath + " into texture atlas page ", m_pages.size() - 1);
+        #endif
+
+        return &m_regions.emplace(imagePath, atlasRegion{&page->texture, rect}).first->second;
+    }
+
+    const atlasRegion* TextureAtlas::findRegion(const std::string& imagePath) const {
+        const auto it = m_regions.find(imagePath);
+        if (it == m_regions.end()) return nullptr;
+
+        return &it->second;
+    }
+
+    [[nodiscard]] std::size_t TextureAtlas::getPageCount() const noexcept {
+        return m_pages.size();
+    }
+}
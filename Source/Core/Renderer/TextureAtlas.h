@@ -0,0 +1,74 @@
+//
+// Author: DirgeWuff
+// Created on: 10/18/26
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Module purpose/description:
+//
+// Texture atlas class declaration. Packs tilesets, image layers and sprite
+// sheets into a small number of large textures at load time, so that tiles,
+// layers and entities can be drawn without switching textures and rlgl can
+// batch them together.
+
+#ifndef TEXTUREATLAS_H
+#define TEXTUREATLAS_H
+
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include "raylib.h"
+
+namespace RE::Core {
+    // Where an image ended up. Source rects for the image must be offset by rect.x/rect.y.
+    struct atlasRegion {
+        Texture2D* texture;
+        Rectangle rect;
+    };
+
+    // Images are packed into rows (shelves) left to right, a new shelf is opened when a row is full.
+    struct atlasShelf {
+        int cursorX;
+        int shelfY;
+        int shelfHeight;
+    };
+
+    struct atlasPage {
+        Texture2D texture;
+        atlasShelf shelf;
+    };
+
+    // Finds room for an image on a square page, padding included. Returns false if the page is full.
+    // Shared with the offline map compiler, which packs smaller pages that fit inside a runtime one.
+    [[nodiscard]] bool packIntoShelf(atlasShelf& shelf, int pageSize, int width, int height, Vector2& position);
+
+    class TextureAtlas {
+        std::deque<atlasPage> m_pages{}; // Deque so region texture pointers stay valid as pages are added
+        std::unordered_map<std::string, atlasRegion> m_regions{};
+
+        [[nodiscard]] atlasPage* findSpace(int width, int height, Vector2& position);
+    public:
+        TextureAtlas();
+        ~TextureAtlas();
+
+        TextureAtlas(const TextureAtlas&) = delete;
+        TextureAtlas(TextureAtlas&&) = delete;
+        TextureAtlas& operator=(const TextureAtlas&) = delete;
+        TextureAtlas& operator=(TextureAtlas&&) = delete;
+
+        // Loads and packs the image, or returns the existing region if it was already added.
+        // Returns nullptr if the image can't be loaded or is too large to be worth atlasing,
+        // in which case the caller should load it as its own texture.
+        [[nodiscard]] const atlasRegion* addImage(const std::string& imagePath);
+
+        // Same as above for an image that's already been decoded, imagePath is only used as the key
+        [[nodiscard]] const atlasRegion* addImage(const std::string& imagePath, const Image& image);
+        [[nodiscard]] const atlasRegion* findRegion(const std::string& imagePath) const;
+        [[nodiscard]] std::size_t getPageCount() const noexcept;
+    };
+}
+
+#endif //TEXTUREATLAS_H
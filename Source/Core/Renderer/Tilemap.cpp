@@ -12,143 +12,676 @@
 // Function definitions for Tilemap.h. Various internal functions used to load a
 // tiled map and construct physics objects.
 
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
 #include "ranges"
 #include "Tilemap.h"
 #include "../../Core/Event/EventCollider.h"
+#include "../Serialization/BinaryMap.h"
+#include "../Utility/MemoryStats.h"
 
 namespace RE::Core {
     class EventCollider;
 
-void loadTilesets(
-    const MapData& mapData,
-    const std::unique_ptr<tson::Map>& map,
-    const std::shared_ptr<RenderData>& renderData)
+// Worker thread stage
+// =====================================================================================================================
+// Decodes the image and queues it for upload. Several layers can share one image, it's only decoded once.
+// Returns the index of the staged texture, or g_noStagedTexture if the image couldn't be loaded.
+std::uint32_t stageMapTexture(
+    const std::string& imagePath,
+    const bool repeats,
+    StagedMap& staged)
 {
-    std::string imagePath;
+    if (const auto it = std::ranges::find(staged.textures, imagePath, &stagedTexture::path);
+        it != staged.textures.end())
+    {
+        it->repeats |= repeats;
+        return static_cast<std::uint32_t>(it - staged.textures.begin());
+    }
+
+    Image image = LoadImage(imagePath.c_str());
+
+    if (!IsImageValid(image)) {
+        staged.error = "Unable to load image: " + imagePath;
+        return g_noStagedTexture;
+    }
+
+    // Converted here so the main thread only has to copy pixels
+    ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+
+    const auto index = static_cast<std::uint32_t>(staged.textures.size());
+    staged.textures.push_back({imagePath, image, repeats});
+
+    Texture2D placeholder{};
+    placeholder.id = index;
+    placeholder.width = image.width;
+    placeholder.height = image.height;
+    staged.placeholders.push_back(placeholder);
+
+    return index;
+}
+
+bool loadTilesets(tson::Map& map, StagedMap& staged) {
+    for (const auto& tileset : map.getTilesets()) {
+        const std::uint32_t texture = stageMapTexture(
+            staged.mapData.baseDir.string() + tileset.getImage().string(),
+            false,
+            staged);
+
+        if (texture == g_noStagedTexture) return false;
+
+        staged.tilesetTextures[&tileset] = texture;
+    }
+
+    return true;
+}
+
+bool loadImageLayer(const tson::Layer& layer, StagedMap& staged) {
+    const std::uint32_t texture = stageMapTexture(
+        staged.mapData.baseDir.string() + layer.getImage(),
+        layer.hasRepeatX() || layer.hasRepeatY(),
+        staged);
+
+    if (texture == g_noStagedTexture) return false;
+
+    // Resolved once here so the renderer never has to build the path or look it up
+    renderPassEntry entry = makeRenderPassEntry(layer);
+    entry.kind = mapLayerKind::IMAGE_LAYER;
+
+    staged.layers.push_back({entry, getRenderPassMask(layer), texture});
+    return true;
+}
 
-    for (const auto& tileset : map->getTilesets()) {
-        if (!mapData.baseDir.empty()) {
-            imagePath = mapData.baseDir.string() + tileset.getImage().string();
+bool loadCollisionMesh(tson::Layer& layer, StagedMap& staged) {
+    for (auto& object : layer.getObjects()) {
+        const tson::ObjectType objType = object.getObjectType();
+
+        if (objType == tson::ObjectType::Polyline) {
+            const tson::Vector2i pos = object.getPosition();
+            std::vector<b2Vec2> points;
+            points.reserve(object.getPolylines().size());
+
+            for (const auto& point : object.getPolylines()) {
+                points.push_back(pixelsToMetersVec(v2iAdd(point, pos)));
+            }
+
+            staged.loadedCollisionVerts += points.size();
+
+            // Hand drawn lines have far more vertices than the ground needs, and every one is another segment
+            if (g_simplifyCollision) {
+                points = simplifyPolyline(points, g_collisionSimplifyTolerance, g_collisionSimplifyAngle);
+                if (points.size() < 4) continue;
+            }
+
+            staged.polylines.push_back(std::move(points));
         }
         else {
-            imagePath = tileset.getImage().string();
+            staged.error = "Collision layer contains incompatible type";
+            return false;
         }
+    }
+
+    return true;
+}
+
+bool loadEventColliders(tson::Layer& layer, StagedMap& staged) {
+    for (auto& object : layer.getObjects()) {
+        const tson::Vector2i pos = object.getPosition();
+        const tson::Vector2i size = object.getSize();
+        const Rectangle rect = {
+            static_cast<float>(pos.x),
+            static_cast<float>(pos.y),
+            static_cast<float>(size.x),
+            static_cast<float>(size.y)};
 
-        if (!renderData->textures.contains(imagePath)) {
-            const Texture2D texture = LoadTexture(imagePath.c_str());
-            renderData->textures[imagePath] = texture;
+        if (object.getName() == "MurderBox") {
+            staged.eventColliders.push_back({rect, sensorType::MURDER_BOX});
+        }
+        else if (object.getName() == "Checkpoint") {
+            staged.eventColliders.push_back({rect, sensorType::CHECKPOINT});
         }
+        else if (object.getName() == "MapExit") {
+            mapExit& exit = staged.mapData.mapExits.emplace_back();
+            if (!readMapExit(object, staged.mapData.baseDir, exit, staged.error)) return false;
 
-        renderData->texturePtrs[&tileset] = &renderData->textures[imagePath];
+            staged.eventColliders.push_back({rect, sensorType::MAP_EXIT});
+        }
+        else {
+            staged.error = "Incompatible object layer: " + object.getName();
+            return false;
+        }
     }
+
+    return true;
 }
 
-void loadImageLayer(
-    const MapData& mapData,
-    const tson::Layer& layer,
-    const std::shared_ptr<RenderData>& renderData)
-{
-    std::string imagePath;
+bool readMapExit(tson::Object& object, const fs::path& mapDir, mapExit& exit, std::string& error) {
+    tson::PropertyCollection& props = object.getProperties();
+    tson::Property* target = props.getProperty("targetMap");
 
-    if (!mapData.baseDir.empty()) {
-        imagePath = mapData.baseDir.string() + layer.getImage();
+    if (!target || (target->getType() != tson::Type::String && target->getType() != tson::Type::File)) {
+        error = "MapExit " + std::to_string(object.getId()) + " has no string or file property \"targetMap\"";
+        return false;
     }
-    else {
-        imagePath = layer.getImage();
+
+    const std::string targetPath = target->getType() == tson::Type::File
+        ? target->getValue<fs::path>().string()
+        : target->getValue<std::string>();
+
+    exit.rect = {
+        static_cast<float>(object.getPosition().x),
+        static_cast<float>(object.getPosition().y),
+        static_cast<float>(object.getSize().x),
+        static_cast<float>(object.getSize().y)};
+    exit.targetMap = (mapDir / targetPath).lexically_normal();
+    exit.hasTargetPos = props.hasProperty("targetX") && props.hasProperty("targetY");
+
+    if (exit.hasTargetPos) {
+        const tson::Property* targetX = props.getProperty("targetX");
+        const tson::Property* targetY = props.getProperty("targetY");
+
+        if (targetX->getType() != tson::Type::Float || targetY->getType() != tson::Type::Float) {
+            error = "MapExit " + std::to_string(object.getId()) + " has non-float targetX or targetY";
+            return false;
+        }
+
+        exit.targetPos = {props.getValue<float>("targetX"), props.getValue<float>("targetY")};
     }
 
-    const Texture texture = LoadTexture(imagePath.c_str());
-    renderData->textures[imagePath] = texture;
+    return true;
 }
 
-void loadCollisionMesh(
-    MapData& mapData,
-    tson::Layer& layer,
-    b2WorldId world)
-{
-    for (auto& object : layer.getObjects()) {
-        const tson::ObjectType objType = object.getObjectType();
+bool readLight(tson::Object& object, lightSource& light, std::string& error) {
+    tson::PropertyCollection& props = object.getProperties();
+    const std::string objectName = "Light " + std::to_string(object.getId());
 
-        if (objType == tson::ObjectType::Polyline) {
-            tson::Vector2i pos = object.getPosition();
-            std::vector<tson::Vector2i> tsonPoints = object.getPolylines();
-            std::vector<b2Vec2> points;
+    // Ints are allowed too, Tiled makes it easy to add the wrong kind of number property
+    const auto getFloat = [&props, &objectName, &error](const std::string& name, const float fallback, float& value) {
+        const tson::Property* prop = props.getProperty(name);
+        value = fallback;
 
-            for (std::size_t i = 0; i < tsonPoints.size(); i++) {
-                tsonPoints[i] = v2iAdd(tsonPoints[i], pos);
-                points.push_back(pixelsToMetersVec(tsonPoints[i]));
-            }
+        if (!prop) return true;
 
-            mapData.collisionObjects.emplace_back(world, points);
+        if (prop->getType() == tson::Type::Float) {
+            value = props.getValue<float>(name);
+        }
+        else if (prop->getType() == tson::Type::Int) {
+            value = static_cast<float>(props.getValue<int>(name));
         }
         else {
-            logFatal("Collision layer contains incompatible type: loadMap(Args...)");
-            return;
+            error = objectName + " has a non-numeric property \"" + name + "\"";
+            return false;
         }
+
+        return true;
+    };
+
+    if (object.getName() == "PointLight") {
+        light.type = lightType::POINT;
+    }
+    else if (object.getName() == "ConeLight") {
+        light.type = lightType::CONE;
+    }
+    else if (object.getName() == "AreaLight") {
+        light.type = lightType::AREA;
     }
+    else {
+        error = "Unknown light \"" + object.getName() + "\", expected \"PointLight\", \"ConeLight\" or \"AreaLight\"";
+        return false;
+    }
+
+    // Point objects have no size, so this is just their position
+    const Vector2 halfSize = {
+        static_cast<float>(object.getSize().x) / 2.0f,
+        static_cast<float>(object.getSize().y) / 2.0f};
+    light.position = {
+        static_cast<float>(object.getPosition().x) + halfSize.x,
+        static_cast<float>(object.getPosition().y) + halfSize.y};
+    light.halfSize = halfSize;
+    light.color = g_defaultLightColor;
+
+    if (const tson::Property* color = props.getProperty("color")) {
+        if (color->getType() != tson::Type::Color) {
+            error = objectName + " has a \"color\" property that isn't a color";
+            return false;
+        }
+
+        const auto value = props.getValue<tson::Colori>("color");
+        light.color = {value.r, value.g, value.b, 255};
+    }
+
+    float directionDegrees = 0.0f;
+    float coneDegrees = 0.0f;
+
+    if (!getFloat("radius", g_defaultLightRadius, light.radius) ||
+        !getFloat("intensity", 1.0f, light.intensity) ||
+        !getFloat("direction", 0.0f, directionDegrees) ||
+        !getFloat("coneAngle", g_defaultConeAngle, coneDegrees) ||
+        !getFloat("softness", g_defaultConeSoftness, light.softness) ||
+        !getFloat("flicker", 0.0f, light.flicker))
+    {
+        return false;
+    }
+
+    // Degrees clockwise from facing right, the same way Tiled rotates objects
+    light.direction = {std::cos(directionDegrees * DEG2RAD), std::sin(directionDegrees * DEG2RAD)};
+    light.coneAngle = coneDegrees * DEG2RAD;
+    light.softness = std::clamp(light.softness, 0.0f, 1.0f);
+    light.flicker = std::clamp(light.flicker, 0.0f, 1.0f);
+
+    if (light.radius <= 0.0f) {
+        error = objectName + " has a radius of zero or less";
+        return false;
+    }
+
+    return true;
 }
 
-void loadEventColliders(
-    MapData& mapData,
-    tson::Layer& layer,
-    b2WorldId world)
-{
-    std::vector<tson::Object> objects = layer.getObjects();
-
-     for (const auto& object : layer.getObjects()) {
-         const tson::Vector2i pos = object.getPosition();
-         const tson::Vector2i size = object.getSize();
-
-         if (object.getName() == "MurderBox") {
-             mapData.eventColliders.emplace_back(
-                static_cast<float>(pos.x),
-                static_cast<float>(pos.y),
-                static_cast<float>(size.x),
-                static_cast<float>(size.y),
-                sensorType::MURDER_BOX,
-                world);
-         }
-         else if (object.getName() == "Checkpoint") {
-             mapData.eventColliders.emplace_back(
-                 static_cast<float>(pos.x),
-                 static_cast<float>(pos.y),
-                 static_cast<float>(size.x),
-                 static_cast<float>(size.y),
-                 sensorType::CHECKPOINT,
-                 world);
-         }
-         else {
-             logFatal(std::string("Incompatible object layer: " + object.getName() + "loadMap(Args...)"));
-             return;
-         }
-     }
-}
-
-void loadTileLayer(
-    tson::Layer& layer,
-    const std::shared_ptr<RenderData>& renderData)
-{
-    std::vector<TileData> layerData;
+bool loadLights(tson::Layer& layer, StagedMap& staged) {
+    staged.mapData.lights.reserve(staged.mapData.lights.size() + layer.getObjects().size());
+
+    for (auto& object : layer.getObjects()) {
+        if (!readLight(object, staged.mapData.lights.emplace_back(), staged.error)) return false;
+    }
+
+    return true;
+}
+
+bool loadTileLayer(tson::Layer& layer, StagedMap& staged) {
+    std::vector<TileData> unsortedTiles;
+    unsortedTiles.reserve(layer.getTileObjects().size());
 
     for (auto& tile : std::views::values(layer.getTileObjects())) {
         const tson::Tile* tilePtr = tile.getTile();
         const tson::Tileset* tileset = tilePtr->getTileset();
 
-        auto it = renderData->texturePtrs.find(tileset);
-        if (it == renderData->texturePtrs.end()) {
-            logFatal("Texture missing: loadMap(Args...)");
-            break;
+        const auto it = staged.tilesetTextures.find(tileset);
+        if (it == staged.tilesetTextures.end()) {
+            staged.error = "Texture missing for a tile in layer " + layer.getName();
+            return false;
         }
 
+        // Drawing rects stay relative to the tileset image until it's uploaded
         TileData tileData;
         tileData.position = toRayVec2(tile.getPosition());
         tileData.sourceRect = toRayRect(tile.getDrawingRect());
-        tileData.texture = it->second;
+        tileData.texture = &staged.placeholders[it->second];
+
+        unsortedTiles.push_back(tileData);
+    }
+
+    renderPassEntry entry = makeRenderPassEntry(layer);
+    entry.kind = mapLayerKind::TILE_LAYER;
+    entry.tileLayerIndex = staged.tileLayers.size();
+
+    bucketTileLayer(unsortedTiles, getTileChunkSize(staged.mapData), staged.tileLayers.emplace_back());
+    staged.layers.push_back({entry, getRenderPassMask(layer), g_noStagedTexture});
+
+    return true;
+}
+
+bool stageTiledMap(const fs::path& mapPath, StagedMap& staged) {
+    MapData& mapData = staged.mapData;
+
+    // Validate the filepath.
+    if (!exists(mapPath)) {
+        staged.error = "Invalid filepath to map: " + mapPath.string();
+        return false;
+    }
+
+    mapData.baseDir = fs::relative(mapPath);
+    mapData.fullMapPath = fs::relative(mapPath);
+    if (mapData.baseDir.has_extension()) {
+        mapData.baseDir.remove_filename();
+    }
+
+    try {
+        tson::Tileson t;
+        std::unique_ptr<tson::Map> map = t.parse(mapPath);
+
+        if (map->getStatus() != tson::ParseStatus::OK) {
+            staged.error = "Unable to parse map: " + map->getStatusMessage();
+            return false;
+        }
+
+        // Same checks as redeye-mapc, so nothing below has to bail out halfway through a layer
+        const std::vector<std::string> problems = validateTiledMap(*map, mapData.baseDir);
+        if (!problems.empty()) {
+            staged.error = problems.front();
+            return false;
+        }
+
+        // Streamed maps are read a region at a time out of their .rmap, so compile one and load that instead
+        if (map->getProperties().hasProperty("streamed") && map->getProperties().getValue<bool>("streamed")) {
+            fs::path binaryPath = mapPath;
+            binaryPath.replace_extension(".rmap");
+
+            if (!writeBinaryMap(*map, mapPath, binaryPath, {true, true}, staged.error)) return false;
+
+            #ifdef DEBUG
+                staged.residentBytesWithDom = getResidentMemoryBytes();
+            #endif
+
+            map.reset();
+
+            #ifdef DEBUG
+                staged.residentBytesWithoutDom = getResidentMemoryBytes();
+            #endif
+
+            if (!stageBinaryMap(binaryPath, staged)) return false;
+
+            staged.mapData.fullMapPath = fs::relative(mapPath);
+            return true;
+        }
+
+        // Map dimensions are needed up front to build the tile chunk grids
+        mapData.mapWidth = map->getSize().x;
+        mapData.mapHeight = map->getSize().y;
+        mapData.tileWidth = map->getTileSize().x;
+        mapData.tileHeight = map->getTileSize().y;
+
+        const std::size_t stepCount = map->getTilesets().size() + map->getLayers().size();
+        std::size_t stepsDone = map->getTilesets().size();
+
+        if (!loadTilesets(*map, staged)) return false;
+        setStagingProgress(staged, stepsDone, stepCount);
+
+        for (auto& layer : map->getLayers()) {
+            bool isLoaded = true;
+
+            if (layer.getType() == tson::LayerType::ImageLayer) {
+                isLoaded = loadImageLayer(layer, staged);
+            }
+            else if (layer.getType() == tson::LayerType::ObjectGroup && layer.getName() == "Collision mesh") {
+                isLoaded = loadCollisionMesh(layer, staged);
+            }
+            else if (layer.getType() == tson::LayerType::ObjectGroup && layer.getName() == "Event colliders") {
+                isLoaded = loadEventColliders(layer, staged);
+            }
+            else if (layer.getType() == tson::LayerType::ObjectGroup && layer.getName() == "Lights") {
+                isLoaded = loadLights(layer, staged);
+            }
+            else if (layer.getType() == tson::LayerType::TileLayer) {
+                isLoaded = loadTileLayer(layer, staged);
+            }
+            else {
+                staged.error = "Incompatible layer type: Group Layer";
+                isLoaded = false;
+            }
+
+            if (!isLoaded) return false;
+            setStagingProgress(staged, ++stepsDone, stepCount);
+        }
+
+        // Handle embedded map properties, presence and types were checked by validateTiledMap
+        tson::PropertyCollection& props = map->getProperties();
+        mapData.playerStartPos = {props.getValue<float>("playerStartX"), props.getValue<float>("playerStartY")};
+        mapData.bgNoisePath = fs::path(props.getValue<std::string>("bgNoisePath"));
+
+        // Everything needed at runtime has been copied out, so the DOM and its strings can go
+        staged.tilesetTextures.clear();
+
+        #ifdef DEBUG
+            staged.residentBytesWithDom = getResidentMemoryBytes();
+        #endif
+
+        map.reset();
+
+        #ifdef DEBUG
+            staged.residentBytesWithoutDom = getResidentMemoryBytes();
+        #endif
+    }
+    catch (const std::exception& e) {
+        staged.error = std::string("Staging failed: ") + e.what();
+        return false;
+    }
+    catch (...) {
+        staged.error = "Staging failed, an unknown error has occurred";
+        return false;
+    }
+
+    return true;
+}
+
+bool stageMap(const fs::path& mapPath, StagedMap& staged) {
+    if (mapPath.extension() == ".rmap") {
+        return stageBinaryMap(mapPath, staged);
+    }
+
+    fs::path binaryPath = mapPath;
+    binaryPath.replace_extension(".rmap");
+
+    // Compiled by redeye-mapc, or for a streamed map, and nothing it was compiled from has changed since
+    if (isBinaryMapCurrent(binaryPath)) {
+        if (stageBinaryMap(binaryPath, staged)) {
+            // Saves should keep pointing at the authoring file
+            staged.mapData.fullMapPath = fs::relative(mapPath);
+            return true;
+        }
+
+        // Most likely compiled by an older version, the .tmj is still good
+        unloadStagedMap(staged);
+        staged = StagedMap{};
+    }
+
+    return stageTiledMap(mapPath, staged);
+}
+
+void setStagingProgress(StagedMap& staged, const std::size_t stepsDone, const std::size_t stepCount) {
+    staged.progress.fraction.store(
+        static_cast<float>(stepsDone) / static_cast<float>(std::max<std::size_t>(stepCount, 1)),
+        std::memory_order_relaxed);
+}
+
+Vector2 getTileChunkSize(const MapData& mapData) {
+    return {
+        static_cast<float>(mapData.tileWidth * g_tileChunkSize),
+        static_cast<float>(mapData.tileHeight * g_tileChunkSize)};
+}
+
+void bucketTileLayer(
+    const std::vector<TileData>& unsortedTiles,
+    const Vector2 chunkSizePx,
+    TileLayerData& layerData)
+{
+    layerData.tiles.clear();
+    layerData.chunkSizePx = chunkSizePx;
+
+    if (unsortedTiles.empty()) {
+        layerData.chunkStarts = {0};
+        layerData.chunksX = 0;
+        layerData.chunksY = 0;
+        return;
+    }
+
+    // Find the extents of the layer so the chunk grid covers every tile, even ones
+    // sitting outside the map bounds or ones larger than a single map tile.
+    Vector2 minPos = unsortedTiles.front().position;
+    Vector2 maxPos = minPos;
+    layerData.maxTileSizePx = {};
+
+    for (const auto& tile : unsortedTiles) {
+        minPos.x = std::min(minPos.x, tile.position.x);
+        minPos.y = std::min(minPos.y, tile.position.y);
+        maxPos.x = std::max(maxPos.x, tile.position.x);
+        maxPos.y = std::max(maxPos.y, tile.position.y);
+        layerData.maxTileSizePx.x = std::max(layerData.maxTileSizePx.x, tile.sourceRect.width);
+        layerData.maxTileSizePx.y = std::max(layerData.maxTileSizePx.y, tile.sourceRect.height);
+    }
+
+    layerData.gridOrigin = minPos;
+    layerData.chunksX = static_cast<std::uint16_t>((maxPos.x - minPos.x) / layerData.chunkSizePx.x) + 1;
+    layerData.chunksY = static_cast<std::uint16_t>((maxPos.y - minPos.y) / layerData.chunkSizePx.y) + 1;
+
+    const auto chunkIndexOf = [&layerData](const TileData& tile) {
+        const auto cx = static_cast<std::size_t>((tile.position.x - layerData.gridOrigin.x) / layerData.chunkSizePx.x);
+        const auto cy = static_cast<std::size_t>((tile.position.y - layerData.gridOrigin.y) / layerData.chunkSizePx.y);
+
+        return cy * layerData.chunksX + cx;
+    };
+
+    // Counting sort the tiles into their chunks so each chunk is one contiguous range.
+    const std::size_t chunkCount = static_cast<std::size_t>(layerData.chunksX) * layerData.chunksY;
+    layerData.chunkStarts.assign(chunkCount + 1, 0);
+
+    for (const auto& tile : unsortedTiles) {
+        layerData.chunkStarts[chunkIndexOf(tile) + 1]++;
+    }
+
+    for (std::size_t i = 1; i <= chunkCount; i++) {
+        layerData.chunkStarts[i] += layerData.chunkStarts[i - 1];
+    }
+
+    std::vector<std::uint32_t> writeHeads(layerData.chunkStarts.begin(), layerData.chunkStarts.end() - 1);
+    layerData.tiles.resize(unsortedTiles.size());
+
+    for (const auto& tile : unsortedTiles) {
+        layerData.tiles[writeHeads[chunkIndexOf(tile)]++] = tile;
+    }
+}
 
-        layerData.push_back(tileData);
+std::size_t addTileLayer(
+    TileLayerData&& layerData,
+    const std::shared_ptr<RenderData>& renderData)
+{
+    // Render textures are created lazily the first time a chunk is seen
+    if (!layerData.tiles.empty()) {
+        layerData.bakedChunks.resize(layerData.chunkStarts.size() - 1);
+        buildTileBatches(layerData);
     }
 
-    renderData->layerRenderData[&layer] = std::move(layerData);
+    renderData->tileLayers.push_back(std::move(layerData));
+    return renderData->tileLayers.size() - 1;
+}
+
+// Tiles can hang off the right/bottom of their chunk, so baked chunks are padded by the largest tile
+std::size_t getBakedChunkBytes(const TileLayerData& layerData) {
+    const auto width = static_cast<std::size_t>(layerData.chunkSizePx.x + layerData.maxTileSizePx.x);
+    const auto height = static_cast<std::size_t>(layerData.chunkSizePx.y + layerData.maxTileSizePx.y);
+
+    return width * height * 4;
+}
+
+void unloadBakedChunks(TileLayerData& layerData, RenderData& renderData) {
+    for (auto& chunk : layerData.bakedChunks) {
+        if (chunk.isBaked) {
+            UnloadRenderTexture(chunk.target);
+            chunk.isBaked = false;
+            renderData.bakedChunkBytes -= getBakedChunkBytes(layerData);
+        }
+    }
+}
+
+void buildTileBatches(TileLayerData& layerData) {
+    layerData.batches.clear();
+
+    const std::size_t chunkCount = layerData.chunkStarts.size() - 1;
+
+    for (std::size_t chunk = 0; chunk < chunkCount; chunk++) {
+        // Chunk boundaries for every batch, including ones with no quads in this chunk
+        for (auto& batch : layerData.batches) {
+            batch.chunkStarts.push_back(static_cast<std::uint32_t>(batch.vertices.size() / 4));
+        }
+
+        for (std::uint32_t i = layerData.chunkStarts[chunk]; i < layerData.chunkStarts[chunk + 1]; i++) {
+            const TileData& tile = layerData.tiles[i];
+
+            // Tilemaps rarely use more than a couple tilesets, a linear search is fine
+            auto it = std::ranges::find_if(layerData.batches, [&tile](const tileBatch& batch) {
+                return batch.texture == tile.texture;
+            });
+
+            if (it == layerData.batches.end()) {
+                tileBatch newBatch{};
+                newBatch.texture = tile.texture;
+                newBatch.chunkStarts.assign(chunk + 1, 0);
+                layerData.batches.push_back(std::move(newBatch));
+                it = layerData.batches.end() - 1;
+            }
+
+            appendTileQuad(it->vertices, tile, {0.0f, 0.0f});
+        }
+    }
+
+    for (auto& batch : layerData.batches) {
+        batch.chunkStarts.push_back(static_cast<std::uint32_t>(batch.vertices.size() / 4));
+    }
+
+    layerData.batchesDirty = false;
+}
+
+void appendTileQuad(std::vector<tileVertex>& vertices, const TileData& tile, const Vector2 offset) {
+    const float texWidth = static_cast<float>(tile.texture->width);
+    const float texHeight = static_cast<float>(tile.texture->height);
+    const Rectangle& src = tile.sourceRect;
+
+    const float left = tile.position.x + offset.x;
+    const float top = tile.position.y + offset.y;
+    const float right = left + std::fabs(src.width);
+    const float bottom = top + std::fabs(src.height);
+
+    // Negative source sizes mean a flipped tile, same as DrawTextureRec
+    float u0 = src.x / texWidth;
+    float v0 = src.y / texHeight;
+    float u1 = (src.x + std::fabs(src.width)) / texWidth;
+    float v1 = (src.y + std::fabs(src.height)) / texHeight;
+    if (src.width < 0.0f) std::swap(u0, u1);
+    if (src.height < 0.0f) std::swap(v0, v1);
+
+    // Same winding as raylib's DrawTexturePro: TL, BL, BR, TR
+    vertices.push_back({left, top, u0, v0});
+    vertices.push_back({left, bottom, u0, v1});
+    vertices.push_back({right, bottom, u1, v1});
+    vertices.push_back({right, top, u1, v0});
+}
+
+// Fills in everything but the kind and the texture/tile layer handle
+renderPassEntry makeRenderPassEntry(const tson::Layer& layer) {
+    renderPassEntry entry{};
+    entry.parallax = toRayVec2(layer.getParallax());
+    entry.offset = toRayVec2(layer.getOffset());
+    entry.repeatX = layer.hasRepeatX();
+    entry.repeatY = layer.hasRepeatY();
+
+    // Tileson reports opaque black when a layer has no tint set
+    const tson::Colori tint = layer.getTintColor();
+    entry.tint = tint == tson::Colori(0, 0, 0, 255) ?
+        WHITE :
+        Color{
+            static_cast<unsigned char>(tint.r),
+            static_cast<unsigned char>(tint.g),
+            static_cast<unsigned char>(tint.b),
+            static_cast<unsigned char>(tint.a)};
+    entry.tint = Fade(entry.tint, layer.getOpacity() * static_cast<float>(entry.tint.a) / 255.0f);
+
+    return entry;
+}
+
+// Layers with no class are drawn in both passes
+std::uint8_t getRenderPassMask(const tson::Layer& layer) {
+    // Hidden layers are hidden in Tiled too, so don't bother drawing them
+    if (!layer.isVisible()) return 0;
+
+    std::uint8_t passMask = 0;
+    if (layer.getClassType() != "DifferedLayer") passMask |= g_primaryPassBit;
+    if (layer.getClassType() != "PrimaryLayer") passMask |= g_differedPassBit;
+
+    return passMask;
+}
+
+bool isStreamedLayer(const renderPassEntry& entry) {
+    return entry.kind == mapLayerKind::TILE_LAYER && entry.parallax.x == 1.0f && entry.parallax.y == 1.0f;
+}
+
+void addRenderPassEntry(
+    const renderPassEntry& entry,
+    const std::uint8_t passMask,
+    const std::shared_ptr<RenderData>& renderData)
+{
+    if (passMask & g_primaryPassBit) renderData->primaryPass.push_back(entry);
+    if (passMask & g_differedPassBit) renderData->differedPass.push_back(entry);
 }
 
 void disableEventCollider(const MapData& map, const guid& colliderGuid) {
@@ -160,12 +693,317 @@ void disableEventCollider(const MapData& map, const guid& colliderGuid) {
 }
 
 void unloadMap(const MapData& map) {
+    if (!map.renderDataPtr) return;
+
     for (const auto& texture : std::views::values(map.renderDataPtr->textures)) {
         UnloadTexture(texture);
     }
 
+    for (auto& layerData : map.renderDataPtr->tileLayers) {
+        unloadBakedChunks(layerData, *map.renderDataPtr);
+    }
+
+    for (auto& regionLayers : std::views::values(map.renderDataPtr->streamedTileLayers)) {
+        for (auto& layerData : regionLayers) {
+            unloadBakedChunks(layerData, *map.renderDataPtr);
+        }
+    }
+
+    map.renderDataPtr->streamedTileLayers.clear();
+    map.renderDataPtr->bakedChunkBytes = 0;
+
     #ifdef DEBUG
         logDbg("Tilemap unloaded successfully.");
     #endif
 }
-}
\ No newline at end of file
+
+mapMemoryStats getMapMemoryStats(const MapData& map) {
+    mapMemoryStats stats{};
+
+    const auto addLayer = [&stats](const TileLayerData& layerData) {
+        stats.tiles += sizeof(TileLayerData) + layerData.tiles.capacity() * sizeof(TileData);
+        stats.chunkIndex += layerData.chunkStarts.capacity() * sizeof(std::uint32_t) +
+            layerData.bakedChunks.capacity() * sizeof(bakedChunk);
+
+        for (const auto& batch : layerData.batches) {
+            stats.tileBatches += sizeof(tileBatch) + batch.vertices.capacity() * sizeof(tileVertex) +
+                batch.chunkStarts.capacity() * sizeof(std::uint32_t);
+        }
+    };
+
+    if (map.renderDataPtr) {
+        const RenderData& renderData = *map.renderDataPtr;
+
+        for (const auto& layerData : renderData.tileLayers) {
+            addLayer(layerData);
+        }
+
+        for (const auto& regionLayers : std::views::values(renderData.streamedTileLayers)) {
+            for (const auto& layerData : regionLayers) {
+                addLayer(layerData);
+            }
+        }
+
+        stats.renderPasses = (renderData.primaryPass.capacity() + renderData.differedPass.capacity()) *
+            sizeof(renderPassEntry);
+
+        for (const auto& texture : std::views::values(renderData.textures)) {
+            const int bytes = GetPixelDataSize(texture.width, texture.height, texture.format);
+            stats.textureVram += static_cast<std::size_t>(bytes);
+        }
+
+        stats.bakedChunkVram = renderData.bakedChunkBytes;
+    }
+
+    stats.collision = map.collisionObjects.getMemoryBytes();
+
+    stats.sensors = map.eventColliders.capacity() * sizeof(EventCollider) +
+        map.eventColliders.size() * sizeof(sensorInfo) +
+        map.mapExits.capacity() * sizeof(mapExit);
+
+    return stats;
+}
+
+#ifdef DEBUG
+void logMapMemoryStats(const MapData& map, const StagedMap& staged) {
+    constexpr double mib = 1024.0 * 1024.0;
+    const mapMemoryStats stats = getMapMemoryStats(map);
+
+    const auto toMib = [](const std::size_t bytes) {
+        return static_cast<double>(bytes) / mib;
+    };
+
+    logDbg(
+        "Map memory for ", map.fullMapPath.string(), " in MiB. Tiles: ", toMib(stats.tiles),
+        ", tile batches: ", toMib(stats.tileBatches), ", chunk index: ", toMib(stats.chunkIndex),
+        ", render passes: ", toMib(stats.renderPasses), ", collision: ", toMib(stats.collision),
+        ", sensors: ", toMib(stats.sensors), ", texture VRAM: ", toMib(stats.textureVram),
+        ", baked chunk VRAM: ", toMib(stats.bakedChunkVram));
+
+    if (staged.residentBytesWithDom != 0) {
+        logDbg(
+            "Process RSS with the Tileson DOM: ", toMib(staged.residentBytesWithDom),
+            " MiB, after freeing it: ", toMib(staged.residentBytesWithoutDom),
+            " MiB, now: ", toMib(getResidentMemoryBytes()), " MiB.");
+    }
+    else {
+        logDbg("Process RSS: ", toMib(getResidentMemoryBytes()), " MiB.");
+    }
+}
+#endif
+
+void unloadMapPhysics(MapData& map) {
+    map.collisionObjects.destroySplines();
+
+    for (auto& collider : map.eventColliders) {
+        collider.destroyCollider();
+    }
+
+    map.eventColliders.clear();
+}
+
+// Main thread stage
+// =====================================================================================================================
+// Packs the image into the map's atlas, or uploads it as its own texture if it's too big or has to repeat.
+// Returns a region with a null texture if the upload failed.
+atlasRegion uploadMapTexture(
+    const std::string& imagePath,
+    const Image& image,
+    const bool repeats,
+    const std::shared_ptr<RenderData>& renderData)
+{
+    // Repeating layers rely on texture wrapping, so they can't live in the atlas
+    if (!repeats && renderData->atlas) {
+        if (const atlasRegion* region = renderData->atlas->addImage(imagePath, image)) return *region;
+    }
+
+    auto it = renderData->textures.find(imagePath);
+    if (it == renderData->textures.end()) {
+        const Texture texture = LoadTextureFromImage(image);
+
+        if (!IsTextureValid(texture)) return {};
+
+        it = renderData->textures.emplace(imagePath, texture).first;
+    }
+
+    // Repeating layers are drawn as a single quad with UVs past the edge of the texture
+    if (repeats) {
+        SetTextureWrap(it->second, TEXTURE_WRAP_REPEAT);
+    }
+
+    return {
+        &it->second,
+        {0.0f, 0.0f, static_cast<float>(it->second.width), static_cast<float>(it->second.height)}};
+}
+
+bool uploadStagedTextures(
+    StagedMap& staged,
+    const std::shared_ptr<RenderData>& renderData,
+    const double deadline)
+{
+    while (staged.regions.size() < staged.textures.size()) {
+        if (GetTime() >= deadline) return false;
+
+        stagedTexture& texture = staged.textures[staged.regions.size()];
+        const atlasRegion region = uploadMapTexture(texture.path, texture.image, texture.repeats, renderData);
+
+        // Pixels live on the GPU from here on
+        UnloadImage(texture.image);
+        texture.image = {};
+
+        if (!region.texture) {
+            staged.error = "Unable to load texture: " + texture.path;
+            return false;
+        }
+
+        staged.regions.push_back(region);
+    }
+
+    return true;
+}
+
+void resolveStagedLayers(StagedMap& staged, const std::shared_ptr<RenderData>& renderData) {
+    for (auto& layerData : staged.tileLayers) {
+        for (auto& tile : layerData.tiles) {
+            // Source rects are relative to the image, move them to where it sits in the atlas
+            const atlasRegion& region = staged.regions[tile.texture->id];
+            tile.sourceRect.x += region.rect.x;
+            tile.sourceRect.y += region.rect.y;
+            tile.texture = region.texture;
+        }
+
+        addTileLayer(std::move(layerData), renderData);
+    }
+
+    staged.tileLayers.clear();
+
+    for (auto& [entry, passMask, textureIndex] : staged.layers) {
+        if (entry.kind == mapLayerKind::IMAGE_LAYER) {
+            const atlasRegion& region = staged.regions[textureIndex];
+            entry.texture = region.texture;
+
+            entry.sourceRect = entry.sourceRect.width > 0.0f ?
+                Rectangle{
+                    region.rect.x + entry.sourceRect.x,
+                    region.rect.y + entry.sourceRect.y,
+                    entry.sourceRect.width,
+                    entry.sourceRect.height} :
+                region.rect;
+        }
+
+        addRenderPassEntry(entry, passMask, renderData);
+    }
+
+    staged.layers.clear();
+}
+
+bool createStagedPhysics(StagedMap& staged, const b2WorldId world, const double deadline) {
+    MapData& mapData = staged.mapData;
+    mapData.eventColliders.reserve(staged.eventColliders.size());
+
+    std::size_t vertCount = 0;
+    for (const auto& polyline : staged.polylines) {
+        vertCount += polyline.size();
+    }
+
+    if (mapData.collisionObjects.size() == 0) mapData.collisionObjects.reserve(staged.polylines.size(), vertCount);
+
+    while (mapData.collisionObjects.size() < staged.polylines.size()) {
+        if (GetTime() >= deadline) return false;
+
+        mapData.collisionObjects.addSpline(world, staged.polylines[mapData.collisionObjects.size()]);
+    }
+
+    while (mapData.eventColliders.size() < staged.eventColliders.size()) {
+        if (GetTime() >= deadline) return false;
+
+        const auto& [rect, type] = staged.eventColliders[mapData.eventColliders.size()];
+        mapData.eventColliders.emplace_back(rect.x, rect.y, rect.width, rect.height, type, world);
+    }
+
+    // A chain created more than once leaves extra segments on the body
+    assert(mapData.collisionObjects.isShapeCountValid());
+
+    #ifdef DEBUG
+        // Compiled maps were simplified by redeye-mapc, so there's no count from before
+        if (staged.loadedCollisionVerts != 0) {
+            logDbg(
+                "Collision simplified from ", staged.loadedCollisionVerts, " to ", vertCount, " vertices over ",
+                mapData.collisionObjects.size(), " splines, ", mapData.collisionObjects.getShapeCount(),
+                " Box2D shapes.");
+        }
+        else {
+            logDbg(
+                "Collision has ", vertCount, " vertices over ", mapData.collisionObjects.size(), " splines, ",
+                mapData.collisionObjects.getShapeCount(), " Box2D shapes.");
+        }
+    #endif
+
+    return true;
+}
+
+MapData finishStagedMap(StagedMap& staged, const b2WorldId world, const std::shared_ptr<TextureAtlas>& atlas) {
+    constexpr double noDeadline = std::numeric_limits<double>::infinity();
+
+    const auto data = std::make_shared<RenderData>();
+    data->atlas = atlas;
+    staged.mapData.renderDataPtr = data;
+
+    if (!uploadStagedTextures(staged, data, noDeadline)) {
+        logFatal(staged.error + ". loadMap(Args...)");
+        unloadStagedMap(staged);
+        unloadMap(staged.mapData);
+        return {};
+    }
+
+    resolveStagedLayers(staged, data);
+    createStagedPhysics(staged, world, noDeadline);
+
+    #ifdef DEBUG
+        logMapMemoryStats(staged.mapData, staged);
+    #endif
+
+    return std::move(staged.mapData);
+}
+
+void unloadStagedMap(StagedMap& staged) {
+    for (auto& texture : staged.textures) {
+        if (texture.image.data) {
+            UnloadImage(texture.image);
+            texture.image = {};
+        }
+    }
+}
+
+// Synchronous loading
+// =====================================================================================================================
+MapData loadTiledMap(const fs::path& mapPath, const b2WorldId world, const std::shared_ptr<TextureAtlas>& atlas) {
+    StagedMap staged;
+
+    if (!stageTiledMap(mapPath, staged)) {
+        logFatal(staged.error + ". loadMap(Args...)");
+        unloadStagedMap(staged);
+        return {};
+    }
+
+    MapData mapData = finishStagedMap(staged, world, atlas);
+
+    #ifdef DEBUG
+        logDbg("Tilemap loaded successfully.");
+    #endif
+
+    return mapData;
+}
+
+MapData loadMap(const fs::path& mapPath, const b2WorldId world, const std::shared_ptr<TextureAtlas>& atlas) {
+    StagedMap staged;
+
+    if (!stageMap(mapPath, staged)) {
+        logFatal(staged.error + ". loadMap(Args...)");
+        unloadStagedMap(staged);
+        return {};
+    }
+
+    return finishStagedMap(staged, world, atlas);
+}
+}
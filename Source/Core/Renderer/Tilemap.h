@@ -16,14 +16,19 @@
 #ifndef TILEMAP_H
 #define TILEMAP_H
 
+#include <atomic>
 #include <vector>
+#include <deque>
 #include <map>
+#include <string>
+#include <unordered_map>
 #include <filesystem>
 #include <cstdint>
 #include "raylib.h"
 #include "../Event/EventCollider.h"
 #include "../external_libs/Tson/tileson.hpp"
 #include "../Phys/CollisionSpline.h"
+#include "../Renderer/TextureAtlas.h"
 #include "../Utility/Logging.h"
 #include "../Utility/Utils.h"
 
@@ -40,22 +45,108 @@ namespace RE::Core {
         const Texture2D* texture;
     };
 
-    // Structured data used to render a map.
+    struct tileVertex {
+        float x;
+        float y;
+        float u;
+        float v;
+    };
+
+    // Prebuilt quads for every tile in a layer that shares one tileset texture. Quads are
+    // in layer space and in the same chunk order as TileLayerData::tiles.
+    struct tileBatch {
+        const Texture2D* texture;
+        std::vector<tileVertex> vertices;       // Four per quad
+        std::vector<std::uint32_t> chunkStarts; // Index of each chunk's first quad, plus one end marker
+    };
+
+    // A chunk of a tile layer pre-composited into its own render texture.
+    struct bakedChunk {
+        RenderTexture2D target;
+        std::uint64_t lastUsedFrame;
+        bool isBaked;
+    };
+
+    // All tiles of a single tile layer, bucketed into a grid of fixed-size chunks.
+    // Tiles are stored contiguously, sorted by chunk in row-major order, so the
+    // renderer only has to walk the chunks that overlap the camera.
+    struct TileLayerData {
+        std::vector<TileData> tiles;
+        std::vector<std::uint32_t> chunkStarts; // Index of each chunk's first tile, plus one end marker
+        std::vector<bakedChunk> bakedChunks;    // One per chunk, only populated in tileRenderMode::BAKED
+        std::vector<tileBatch> batches;         // One per tileset texture used by the layer
+        Vector2 gridOrigin;                     // Top-left of chunk (0, 0), in pixels
+        Vector2 chunkSizePx;
+        Vector2 maxTileSizePx;                  // Largest tile in the layer, used to pad the cull rect
+        std::uint16_t chunksX;
+        std::uint16_t chunksY;
+        bool batchesDirty;                      // Set when tiles change, batches get rebuilt on next draw
+    };
+
+    // Which render passes a layer is drawn in
+    constexpr std::uint8_t g_primaryPassBit = 1 << 0;
+    constexpr std::uint8_t g_differedPassBit = 1 << 1;
+
+    // A single drawable layer, resolved from Tileson at load time so the render loop
+    // never has to look at tson objects or strings.
+    struct renderPassEntry {
+        mapLayerKind kind;
+        std::size_t tileLayerIndex; // Index into RenderData::tileLayers, tile layers only
+        const Texture2D* texture;   // Image layers only
+        Rectangle sourceRect;       // Part of the texture holding the image, image layers only
+        Vector2 parallax;
+        Vector2 offset;
+        Color tint;                 // Layer tint with opacity folded into alpha
+        bool repeatX;
+        bool repeatY;
+    };
+
+    // Structured data used to render a map. Textures that didn't fit in the atlas are kept in textures.
+    // In streamed maps, each loaded region brings its own set of tile layers, indexed the same as
+    // tileLayers, and tileLayers only holds the layers that aren't streamed.
     struct RenderData {
-        std::unordered_map<const tson::Tileset*, Texture2D*> texturePtrs;
-        std::unordered_map<const tson::Layer*, std::vector<TileData>> layerRenderData;
+        std::shared_ptr<TextureAtlas> atlas;
+        std::vector<TileLayerData> tileLayers;
+        std::unordered_map<std::uint64_t, std::vector<TileLayerData>> streamedTileLayers; // By region key
+        std::vector<renderPassEntry> primaryPass;
+        std::vector<renderPassEntry> differedPass;
         std::map<std::string, Texture> textures;
+        std::size_t bakedChunkBytes;
+        std::uint64_t frameCounter;
+    };
+
+    // Where a "MapExit" event collider leads. The sensor itself is in MapData::eventColliders.
+    struct mapExit {
+        Rectangle rect;
+        fs::path targetMap;
+        Vector2 targetPos;      // Player center in the target map, in pixels
+        bool hasTargetPos;      // Otherwise the target map's player start is used
+    };
+
+    // A light from the map's "Lights" layer, or one added at runtime through LightManager
+    struct lightSource {
+        Vector2 position;       // Center, in world pixels
+        Vector2 direction;      // Normalized, cone lights only
+        Vector2 halfSize;       // Area lights only
+        Color color;
+        float radius;           // Falloff distance in world pixels, from the edge for area lights
+        float intensity;
+        float coneAngle;        // Full width in radians, cone lights only
+        float softness;         // Fraction of the cone's width that fades out at the edges
+        float flicker;          // 0 for a steady light, up to 1 for one that can flicker fully dark
+        lightType type;
     };
 
     // Structured data used to load a map. Used on a per-map basis.
     struct MapData {
         std::vector<EventCollider> eventColliders;
+        std::vector<mapExit> mapExits;
+        std::vector<lightSource> lights;
         fs::path baseDir;
         fs::path fullMapPath;
         fs::path bgNoisePath;
-        std::vector<CollisionSpline> collisionObjects;
+        CollisionStore collisionObjects;
         std::shared_ptr<RenderData> renderDataPtr;
-        std::shared_ptr<tson::Map> tsonMapPtr;
 
         // Leaving this as a vec2 so I don't need to set player POS in meters in Tiled
         Vector2 playerStartPos;
@@ -64,141 +155,201 @@ namespace RE::Core {
         uint8_t tileHeight;
         uint16_t mapWidth;
         uint16_t mapHeight;
+
+        // Tiles, collision and sensors are left to a WorldStreamer, see WorldStreamer.h
+        bool isStreamed;
     };
 
-    void loadTilesets(
-        const MapData& mapData,
-        const std::unique_ptr<tson::Map>& map,
-        const std::shared_ptr<RenderData>& renderData);
+    // Staged textures are referred to by index until they're uploaded
+    constexpr std::uint32_t g_noStagedTexture = UINT32_MAX;
 
-    void loadImageLayer(
-        const MapData& mapData,
-        const tson::Layer& layer,
-        const std::shared_ptr<RenderData>& renderData);
+    // An image decoded off the main thread, waiting for its texture upload
+    struct stagedTexture {
+        std::string path;
+        Image image;
+        bool repeats;
+    };
+
+    struct stagedLayer {
+        renderPassEntry entry;      // For tile layers, tileLayerIndex indexes StagedMap::tileLayers
+        std::uint8_t passMask;
+        std::uint32_t textureIndex; // Image layers only
+    };
+
+    struct stagedEventCollider {
+        Rectangle rect;
+        sensorType type;
+    };
+
+    // Fraction of the worker stage that's done, written by the worker while loading screens read it.
+    // Copying or assigning one starts it over, so a StagedMap can still be reset by assigning it a new one.
+    struct stagingProgress {
+        std::atomic<float> fraction{};
+
+        stagingProgress() = default;
+        stagingProgress(const stagingProgress&) noexcept {}
+
+        stagingProgress& operator=(const stagingProgress&) noexcept {
+            fraction.store(0.0f, std::memory_order_relaxed);
+            return *this;
+        }
+    };
+
+    // Everything a map load produces that doesn't need the GPU or the physics world, built on a
+    // worker thread. Until their textures are uploaded, tiles point at a placeholder whose id is
+    // the index of its stagedTexture, and source rects are relative to the image. An image layer
+    // source rect with no width means the whole image.
+    struct StagedMap {
+        MapData mapData;
+        std::vector<stagedTexture> textures;
+        std::deque<Texture2D> placeholders;     // One per texture, deque so tile pointers stay valid
+        std::vector<atlasRegion> regions;       // Filled in as textures are uploaded
+        std::vector<TileLayerData> tileLayers;  // Already bucketed into chunks
+        std::vector<stagedLayer> layers;        // In draw order
+        std::vector<std::vector<b2Vec2>> polylines;
+        std::size_t loadedCollisionVerts{};     // Before simplifying, Tiled maps only
+        std::vector<stagedEventCollider> eventColliders;
+        std::unordered_map<const tson::Tileset*, std::uint32_t> tilesetTextures;
+        std::string error;                      // Set when staging or finishing fails
+        stagingProgress progress;               // Images decoded and layers staged, see setStagingProgress
+        std::size_t residentBytesWithDom{};     // Process RSS just before the tson::Map is freed, Tiled maps only
+        std::size_t residentBytesWithoutDom{};  // And just after. Both debug builds only.
+    };
+
+    // Bytes a loaded map is holding on to, by subsystem. Streamed maps only count what's loaded right now.
+    struct mapMemoryStats {
+        std::size_t tiles;
+        std::size_t tileBatches;
+        std::size_t chunkIndex;     // Chunk starts and baked chunk slots
+        std::size_t renderPasses;
+        std::size_t collision;
+        std::size_t sensors;
+        std::size_t textureVram;    // Textures that didn't go in the shared atlas, estimated from their size
+        std::size_t bakedChunkVram;
+    };
 
-    void loadCollisionMesh(
-        MapData& mapData,
-        tson::Layer& layer,
-        b2WorldId world);
+    // Worker thread stage
+    // =================================================================================================================
+    // Nothing here touches the GPU, the physics world or logFatal, problems are reported through StagedMap::error.
 
-    void loadEventColliders(
-        MapData& mapData,
-        tson::Layer& layer,
-        b2WorldId world);
+    [[nodiscard]] std::uint32_t stageMapTexture(
+        const std::string& imagePath,
+        bool repeats,
+        StagedMap& staged);
 
-    void loadTileLayer(
-        tson::Layer& layer,
+    bool loadTilesets(tson::Map& map, StagedMap& staged);
+    bool loadImageLayer(const tson::Layer& layer, StagedMap& staged);
+    bool loadCollisionMesh(tson::Layer& layer, StagedMap& staged);
+    bool loadEventColliders(tson::Layer& layer, StagedMap& staged);
+    bool loadTileLayer(tson::Layer& layer, StagedMap& staged);
+
+    // Reads the targetMap, targetX and targetY properties of a "MapExit" object. targetMap is relative to mapDir.
+    bool readMapExit(tson::Object& object, const fs::path& mapDir, mapExit& exit, std::string& error);
+
+    // Reads a "PointLight", "ConeLight" or "AreaLight" object and its optional properties, see README.md
+    bool readLight(tson::Object& object, lightSource& light, std::string& error);
+    bool loadLights(tson::Layer& layer, StagedMap& staged);
+
+    // Parses a .tmj through Tileson
+    bool stageTiledMap(const fs::path& mapPath, StagedMap& staged);
+
+    // Reads a precompiled .rmap, see BinaryMap.h. Defined in BinaryMap.cpp
+    bool stageBinaryMap(const fs::path& mapPath, StagedMap& staged);
+
+    // Either format. A .tmj with an up to date .rmap next to it stages the .rmap instead.
+    bool stageMap(const fs::path& mapPath, StagedMap& staged);
+
+    // Images and layers each count as one step, decoding an image usually costs more but it's close enough
+    void setStagingProgress(StagedMap& staged, std::size_t stepsDone, std::size_t stepCount);
+
+    [[nodiscard]] Vector2 getTileChunkSize(const MapData& mapData);
+
+    // Fills in the chunk grid of layerData and sorts the tiles into it. Doesn't touch
+    // any GPU resources, so the offline map compiler can pre-chunk layers with it.
+    void bucketTileLayer(
+        const std::vector<TileData>& unsortedTiles,
+        Vector2 chunkSizePx,
+        TileLayerData& layerData);
+
+    [[nodiscard]] renderPassEntry makeRenderPassEntry(const tson::Layer& layer);
+
+    [[nodiscard]] std::uint8_t getRenderPassMask(const tson::Layer& layer);
+
+    // Parallax layers don't line up with the world, so they stay loaded in full even in streamed maps
+    [[nodiscard]] bool isStreamedLayer(const renderPassEntry& entry);
+
+    // Main thread stage
+    // =================================================================================================================
+    // The deadline versions stop once GetTime() passes the deadline and return false, call them again
+    // next frame to carry on. Failures are reported through StagedMap::error.
+
+    [[nodiscard]] atlasRegion uploadMapTexture(
+        const std::string& imagePath,
+        const Image& image,
+        bool repeats,
         const std::shared_ptr<RenderData>& renderData);
 
-    void unloadMap(const MapData& map);
-    void disableEventCollider(const MapData& map, const guid& colliderGuid);
+    bool uploadStagedTextures(
+        StagedMap& staged,
+        const std::shared_ptr<RenderData>& renderData,
+        double deadline);
 
-    // If I end up adding more types, might be good to RTTI this whole thing...
-    template<typename T>
-    float getMapPropFloat(const std::unique_ptr<tson::Map>& map, T& propName) {
-        tson::PropertyCollection props = map->getProperties();
+    // Points tiles and layers at the uploaded textures and builds the render passes. Needs every texture uploaded.
+    void resolveStagedLayers(StagedMap& staged, const std::shared_ptr<RenderData>& renderData);
 
-        if (!props.hasProperty(std::string(propName))) {
-            logFatal(std::string("Map has no property \"" + std::string(propName) +
-                std::string("\". Tilemap::GetMapPropFloat(Args...)")));
-            return {};
-        }
+    bool createStagedPhysics(StagedMap& staged, b2WorldId world, double deadline);
 
-        return props.getValue<float>(propName);
-    }
+    // Runs the whole main thread stage in one go. Logs fatally and returns an empty map on failure.
+    MapData finishStagedMap(StagedMap& staged, b2WorldId world, const std::shared_ptr<TextureAtlas>& atlas);
 
-    template<typename T>
-    std::string getMapPropStr(const std::unique_ptr<tson::Map>& map, T& propName) {
-        tson::PropertyCollection props = map->getProperties();
+    // Frees any decoded images that never got uploaded
+    void unloadStagedMap(StagedMap& staged);
 
-        if (!props.hasProperty(std::string(propName))) {
-            logFatal(std::string("Map has no property \"" + std::string(propName) +
-                std::string("\". Tilemap::GetMapPropStr(Args...)")));
-            return {};
-        }
+    // Appends an already bucketed layer to RenderData::tileLayers. Returns the index of the new layer.
+    std::size_t addTileLayer(
+        TileLayerData&& layerData,
+        const std::shared_ptr<RenderData>& renderData);
 
-        return props.getValue<std::string>(propName);
-    }
+    void buildTileBatches(TileLayerData& layerData);
 
-    template<typename T>
-    MapData loadMap(T&& filepath, const b2WorldId world) {
-        MapData mapData;
+    // Appends the tile's quad, four vertices positioned in layer space plus offset
+    void appendTileQuad(std::vector<tileVertex>& vertices, const TileData& tile, Vector2 offset);
 
-        // Validate the filepath.
-        if (!exists(fs::path(filepath))) {
-            logFatal(std::string("Invalid filepath to map: ") + filepath + std::string("loadMap(Args...)"));
-            return {};
-        }
+    // VRAM used by one baked chunk of the layer
+    [[nodiscard]] std::size_t getBakedChunkBytes(const TileLayerData& layerData);
 
-        mapData.baseDir = fs::relative(filepath);
-        mapData.fullMapPath = fs::relative(filepath);
-        if (mapData.baseDir.has_extension()) {
-            mapData.baseDir.remove_filename();
-        }
+    // Frees any chunks of the layer baked in tileRenderMode::BAKED
+    void unloadBakedChunks(TileLayerData& layerData, RenderData& renderData);
 
-        try {
-            tson::Tileson t;
-            std::unique_ptr<tson::Map> map = t.parse(fs::path(filepath));
-
-            if (map->getStatus() != tson::ParseStatus::OK) {
-                logFatal(
-                    "Constructor init failed: Unable to parse map: " + map->getStatusMessage() + ". loadMap(Args...)");
-                return {};
-            }
-
-            const auto data = std::make_shared<RenderData>();
-            loadTilesets(mapData, map, data);
-
-            for (auto& layer : map->getLayers()) {
-                if (layer.getType() == tson::LayerType::ImageLayer) {
-                    loadImageLayer(mapData, layer, data);
-                }
-                else if (layer.getType() == tson::LayerType::ObjectGroup && layer.getName() == "Collision mesh") {
-                    loadCollisionMesh(mapData, layer, world);
-                }
-                else if (layer.getType() == tson::LayerType::ObjectGroup && layer.getName() == "Event colliders") {
-                    loadEventColliders(mapData, layer, world);
-                }
-                else if (layer.getType() == tson::LayerType::TileLayer) {
-                    loadTileLayer(layer, data);
-                }
-                else {
-                    logFatal("Incompatible layer type: Group Layer: loadMap(Args...)");
-                    return {};
-                }
-            }
-
-            // Handle embedded map properties
-            mapData.playerStartPos = {
-                getMapPropFloat(map, "playerStartX"),
-                getMapPropFloat(map, "playerStartY")};
-
-            mapData.bgNoisePath = fs::path(getMapPropStr(map, "bgNoisePath"));
-
-            // Assign everything else
-            mapData.mapWidth = map->getSize().x;
-            mapData.mapHeight = map->getSize().y;
-            mapData.tileWidth = map->getTileSize().x;
-            mapData.tileHeight = map->getTileSize().y;
-            mapData.tsonMapPtr = std::move(map);
-            mapData.renderDataPtr = data;
+    void addRenderPassEntry(
+        const renderPassEntry& entry,
+        std::uint8_t passMask,
+        const std::shared_ptr<RenderData>& renderData);
 
-        }
-        catch (const std::exception& e) {
-            logFatal(std::string("loadMap(Args...) failed: ") + std::string(e.what()));
-            return {};
-        }
-        catch (...) {
-            logFatal("loadMap(Args...) failed, an unknown error has occurred");
-            return {};
-        }
+    [[nodiscard]] mapMemoryStats getMapMemoryStats(const MapData& map);
+
+    // Logs getMapMemoryStats along with the process RSS, and how much freeing the tson::Map gave back.
+    // Debug builds only.
+    void logMapMemoryStats(const MapData& map, const StagedMap& staged);
+
+    void unloadMap(const MapData& map);
+
+    // Destroys the map's collision chains and sensors. Call before destroying its world, sensors free their
+    // sensorInfo here and nowhere else.
+    void unloadMapPhysics(MapData& map);
+    void disableEventCollider(const MapData& map, const guid& colliderGuid);
+
+    // Synchronous loading, both stages back to back on the calling thread. See MapLoader for the async version.
+    // =================================================================================================================
+
+    // Loads a Tiled .tmj through Tileson
+    MapData loadTiledMap(const fs::path& mapPath, b2WorldId world, const std::shared_ptr<TextureAtlas>& atlas);
 
-        #ifdef DEBUG
-            logDbg("Tilemap loaded successfully.");
-        #endif
+    // Loads a precompiled .rmap
+    MapData loadBinaryMap(const fs::path& mapPath, b2WorldId world, const std::shared_ptr<TextureAtlas>& atlas);
 
-        return mapData;
-    }
+    // Loads a map from either format, see stageMap
+    MapData loadMap(const fs::path& mapPath, b2WorldId world, const std::shared_ptr<TextureAtlas>& atlas);
 }
 
-#endif //TILEMAP_H
\ No newline at end of file
+#endif //TILEMAP_H
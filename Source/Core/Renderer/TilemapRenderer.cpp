@@ -12,140 +12,535 @@
 // Function definitions for TilemapRenderer.h. Includes the primary map rendering
 // function, renderLayer(Args...).
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <ranges>
 #include "raylib.h"
 #include "raymath.h"
+#include "rlgl.h"
 #include "TilemapRenderer.h"
-
-// Very sloppy way of dealing with layers of render pass modes in the same function.
-// Tried to do this using groups, however there seems to be a bug in tson that causes tiled layers not to load properly
-// this seems like the second-best option.
+#include "../Utility/Debug.h"
 
 namespace RE::Core {
-    static void renderLayer(
+    static tileRenderStats s_tileStats{};
+    static std::array<std::vector<tileLayerJob>, static_cast<std::size_t>(renderPassType::COUNT)> s_layerJobs{};
+
+    static Vector2 getLayerDrawOffset(
         const SceneCamera& cam,
-        const MapData& map,
-        const tson::Layer& layer,
-        const Vector2 offset,
-        const Color color)
+        const renderPassEntry& entry,
+        const Vector2 offset)
     {
-        const Vector2 parallaxFactor = toRayVec2(layer.getParallax());
-        const Vector2 layerOffset = toRayVec2(layer.getOffset());
         const Vector2 cameraTarget = cam.getCameraTarget();
-        const Vector2 parallaxOffset = cameraTarget * (Vector2{1.0f, 1.0f} - parallaxFactor);
-        const Vector2 adjustedOffset = offset + layerOffset + parallaxOffset;
-
-        switch (layer.getType()) {
-            case tson::LayerType::TileLayer: {
-                const auto it = map.renderDataPtr->layerRenderData.find(&layer);
-                if (it == map.renderDataPtr->layerRenderData.end()) return;
-
-                for (const auto& tile : it->second) {
-                    const Vector2 drawingPos = {
-                        tile.position.x + adjustedOffset.x,
-                        tile.position.y + adjustedOffset.y
-                    };
-
-                    const Rectangle tileBounds = {
-                        drawingPos.x,
-                        drawingPos.y,
-                        tile.sourceRect.width,
-                        tile.sourceRect.height
-                    };
-
-                    // Camera cull
-                    if (!CheckCollisionRecs(tileBounds, cam.getCameraRect())) {
-                        continue;
-                    }
+        const Vector2 parallaxOffset = cameraTarget * (Vector2{1.0f, 1.0f} - entry.parallax);
 
-                    DrawTextureRec(
-                        *tile.texture,
-                        tile.sourceRect,
-                        drawingPos,
-                        color);
-                }
+        return offset + entry.offset + parallaxOffset;
+    }
+
+    // Move the camera into layer space instead of moving every tile out of it
+    static Rectangle getLayerView(const SceneCamera& cam, const Vector2 adjustedOffset) {
+        const Rectangle camRect = cam.getCameraRect();
+
+        return {
+            camRect.x - adjustedOffset.x,
+            camRect.y - adjustedOffset.y,
+            camRect.width,
+            camRect.height
+        };
+    }
+
+    static chunkRange getVisibleChunks(const TileLayerData& layerData, const Rectangle& layerView) {
+        if (layerData.tiles.empty()) return {0, 0, -1, -1};
+
+        // Tiles are bucketed by their top-left corner, so pad the low edge by the largest tile
+        const float firstX = (layerView.x - layerData.maxTileSizePx.x - layerData.gridOrigin.x) / layerData.chunkSizePx.x;
+        const float firstY = (layerView.y - layerData.maxTileSizePx.y - layerData.gridOrigin.y) / layerData.chunkSizePx.y;
+        const float lastX = (layerView.x + layerView.width - layerData.gridOrigin.x) / layerData.chunkSizePx.x;
+        const float lastY = (layerView.y + layerView.height - layerData.gridOrigin.y) / layerData.chunkSizePx.y;
+
+        if (lastX < 0.0f || lastY < 0.0f || firstX >= layerData.chunksX || firstY >= layerData.chunksY) {
+            return {0, 0, -1, -1};
+        }
+
+        return {
+            std::max(static_cast<int>(std::floor(firstX)), 0),
+            std::max(static_cast<int>(std::floor(firstY)), 0),
+            std::min(static_cast<int>(lastX), layerData.chunksX - 1),
+            std::min(static_cast<int>(lastY), layerData.chunksY - 1)
+        };
+    }
+
+    // Calls func with the tile layer, and with the same layer of every streamed region that's loaded
+    template<typename Func>
+    static void forEachLayerData(RenderData& renderData, const std::size_t tileLayerIndex, Func&& func) {
+        func(renderData.tileLayers[tileLayerIndex]);
 
-                break;
+        for (auto& regionLayers : std::views::values(renderData.streamedTileLayers)) {
+            func(regionLayers[tileLayerIndex]);
+        }
+    }
+
+    static Vector2 getChunkOrigin(const TileLayerData& layerData, const std::size_t chunk) {
+        return {
+            layerData.gridOrigin.x + static_cast<float>(chunk % layerData.chunksX) * layerData.chunkSizePx.x,
+            layerData.gridOrigin.y + static_cast<float>(chunk / layerData.chunksX) * layerData.chunkSizePx.y
+        };
+    }
+
+    static void drawChunkTiles(
+        tileLayerJob& job,
+        const std::size_t chunk,
+        const Rectangle& layerView,
+        const Vector2 adjustedOffset)
+    {
+        const TileLayerData& layerData = *job.layerData;
+        const std::uint32_t first = layerData.chunkStarts[chunk];
+        const std::uint32_t last = layerData.chunkStarts[chunk + 1];
+
+        job.stats.visitedTiles += last - first;
+
+        for (std::uint32_t i = first; i < last; i++) {
+            const TileData& tile = layerData.tiles[i];
+            const Rectangle tileBounds = {
+                tile.position.x,
+                tile.position.y,
+                tile.sourceRect.width,
+                tile.sourceRect.height
+            };
+
+            // Camera cull, for tiles on the edge chunks
+            if (!CheckCollisionRecs(tileBounds, layerView)) {
+                job.stats.culledTiles++;
+                continue;
             }
-            case tson::LayerType::ImageLayer: {
-                const std::string imagePath = map.baseDir.string() + layer.getImage();
 
-                if (!map.renderDataPtr->textures.contains(imagePath)) {
-                    logFatal("Unable to load texture: " + layer.getImage() + ": renderMap(Args...)");
-                    return;
-                }
+            // Tiles are sorted by chunk, not tileset, but neighbours tend to share one
+            if (job.runs.empty() || job.runs.back().texture != tile.texture) {
+                job.runs.push_back({tile.texture, static_cast<std::uint32_t>(job.vertices.size() / 4), 0});
+            }
 
-                if (layer.hasRepeatX()) {
-                    const float camWidth = cam.getCameraRectWidth();
-                    const float imageWidth = map.renderDataPtr->textures[imagePath].width;
-                    const int mapWidth = map.mapWidth * map.tileWidth;
-                    const float camTravelX = mapWidth - camWidth;
-                    const float totalParallaxShift = camTravelX * (1.0f - parallaxFactor.x);
+            appendTileQuad(job.vertices, tile, adjustedOffset);
+            job.runs.back().quadCount++;
+            job.stats.drawnTiles++;
+        }
+    }
 
-                    const std::size_t maxRepetitions = std::ceil((camWidth + totalParallaxShift) / imageWidth);
-                    int xPos = static_cast<int>(adjustedOffset.x);
+    // Must be called outside of texture mode, raylib can't nest render targets
+    static void bakeChunk(RenderData& renderData, TileLayerData& layerData, const std::size_t chunk) {
+        bakedChunk& baked = layerData.bakedChunks[chunk];
+        const Vector2 chunkOrigin = getChunkOrigin(layerData, chunk);
 
-                    for (std::size_t i = 0; i < maxRepetitions; i++) {
-                        DrawTexture(
-                            map.renderDataPtr->textures[imagePath],
-                            xPos,
-                            static_cast<int>(adjustedOffset.y),
-                            color);
+        baked.target = LoadRenderTexture(
+            static_cast<int>(layerData.chunkSizePx.x + layerData.maxTileSizePx.x),
+            static_cast<int>(layerData.chunkSizePx.y + layerData.maxTileSizePx.y));
 
-                        xPos += imageWidth;
-                    }
-                }
-                else {
-                    DrawTexture(
-                        map.renderDataPtr->textures[imagePath],
-                        static_cast<int>(adjustedOffset.x),
-                        static_cast<int>(adjustedOffset.y),
-                        color);
-                }
+        if (!IsRenderTextureValid(baked.target)) {
+            logFatal("Unable to create render texture for baked tile chunk: bakeChunk(Args...)");
+            return;
+        }
+
+        // Alpha is accumulated rather than blended into the blank target, which would leave it squared, so the
+        // chunk comes out premultiplied and is drawn with BLEND_ALPHA_PREMULTIPLY
+        rlSetBlendFactorsSeparate(
+            RL_SRC_ALPHA,
+            RL_ONE_MINUS_SRC_ALPHA,
+            RL_ONE,
+            RL_ONE_MINUS_SRC_ALPHA,
+            RL_FUNC_ADD,
+            RL_FUNC_ADD);
 
-                break;
+        BeginTextureMode(baked.target);
+            ClearBackground(BLANK);
+            BeginBlendMode(BLEND_CUSTOM_SEPARATE);
+
+            for (std::uint32_t i = layerData.chunkStarts[chunk]; i < layerData.chunkStarts[chunk + 1]; i++) {
+                const TileData& tile = layerData.tiles[i];
+
+                DrawTextureRec(
+                    *tile.texture,
+                    tile.sourceRect,
+                    tile.position - chunkOrigin,
+                    WHITE);
             }
-            // Need to handle this even though it's a NOP, otherwise default is hit
-            case tson::LayerType::ObjectGroup: {
-                break;
+            EndBlendMode();
+        EndTextureMode();
+
+        baked.isBaked = true;
+        renderData.bakedChunkBytes += getBakedChunkBytes(layerData);
+    }
+
+    // Evict the least recently used baked chunk, preferring the one furthest from the camera on ties.
+    // Chunks used during the current frame are never evicted. Returns false if nothing could be evicted.
+    static bool evictBakedChunk(
+        const SceneCamera& cam,
+        const MapData& map,
+        const Vector2 offset)
+    {
+        RenderData& renderData = *map.renderDataPtr;
+        TileLayerData* victimLayer = nullptr;
+        std::size_t victimChunk = 0;
+        std::uint64_t victimFrame = renderData.frameCounter;
+        float victimDistance = 0.0f;
+
+        // Layers without a class sit in both passes, visiting them twice is harmless here
+        for (const auto* pass : {&renderData.primaryPass, &renderData.differedPass}) {
+            for (const auto& entry : *pass) {
+                if (entry.kind != mapLayerKind::TILE_LAYER) continue;
+
+                const Rectangle view = getLayerView(cam, getLayerDrawOffset(cam, entry, offset));
+                const Vector2 viewCenter = {view.x + view.width / 2.0f, view.y + view.height / 2.0f};
+
+                forEachLayerData(renderData, entry.tileLayerIndex, [&](TileLayerData& layerData) {
+                    for (std::size_t i = 0; i < layerData.bakedChunks.size(); i++) {
+                        const bakedChunk& chunk = layerData.bakedChunks[i];
+                        if (!chunk.isBaked || chunk.lastUsedFrame >= renderData.frameCounter) continue;
+
+                        const Vector2 chunkCenter = getChunkOrigin(layerData, i) + layerData.chunkSizePx / 2.0f;
+                        const float distance = Vector2Distance(chunkCenter, viewCenter);
+
+                        if (chunk.lastUsedFrame < victimFrame ||
+                            (chunk.lastUsedFrame == victimFrame && distance > victimDistance))
+                        {
+                            victimLayer = &layerData;
+                            victimChunk = i;
+                            victimFrame = chunk.lastUsedFrame;
+                            victimDistance = distance;
+                        }
+                    }
+                });
             }
-            default: {
-                logFatal("Map contains unsupported layer type: renderMap(Args...)");
-                break;
+        }
+
+        if (!victimLayer) return false;
+
+        UnloadRenderTexture(victimLayer->bakedChunks[victimChunk].target);
+        victimLayer->bakedChunks[victimChunk] = {};
+        renderData.bakedChunkBytes -= getBakedChunkBytes(*victimLayer);
+
+        return true;
+    }
+
+    // Rows of visible chunks are contiguous in the quad arrays, so culling only picks a start and
+    // end quad per row. The queue keeps each batch's rows together, so they share one rlgl draw call.
+    static void submitTileBatches(
+        tileLayerJob& job,
+        const chunkRange& range,
+        const Vector2 adjustedOffset)
+    {
+        TileLayerData& layerData = *job.layerData;
+
+        if (layerData.batchesDirty) buildTileBatches(layerData);
+        if (range.maxX < range.minX || range.maxY < range.minY) return;
+
+        // Layer offset and parallax are applied once per row rather than per tile
+        for (const auto& batch : layerData.batches) {
+            for (int cy = range.minY; cy <= range.maxY; cy++) {
+                const std::size_t rowStart = static_cast<std::size_t>(cy) * layerData.chunksX;
+                const std::uint32_t firstQuad = batch.chunkStarts[rowStart + range.minX];
+                const std::uint32_t lastQuad = batch.chunkStarts[rowStart + range.maxX + 1];
+
+                job.queue.drawQuads(
+                    job.pass,
+                    job.depth,
+                    *batch.texture,
+                    batch.vertices.data() + static_cast<std::size_t>(firstQuad) * 4,
+                    lastQuad - firstQuad,
+                    adjustedOffset,
+                    job.color);
+
+                job.stats.visitedTiles += lastQuad - firstQuad;
+                job.stats.drawnTiles += lastQuad - firstQuad;
             }
         }
     }
 
+    // Runs on a render worker, touches nothing outside of job
+    static void renderTileLayer(const SceneCamera& cam, tileLayerJob& job) {
+        TileLayerData& layerData = *job.layerData;
+
+        job.queue.resetStats();
+        job.vertices.clear();
+        job.runs.clear();
+        job.stats = {};
+        job.stats.totalTiles = layerData.tiles.size();
+
+        const Vector2 adjustedOffset = getLayerDrawOffset(cam, *job.entry, job.offset);
+        const Rectangle layerView = getLayerView(cam, adjustedOffset);
+        const chunkRange range = getVisibleChunks(layerData, layerView);
+
+        if (toEnum<tileRenderMode>(g_tileRenderMode) == tileRenderMode::BATCHED) {
+            submitTileBatches(job, range, adjustedOffset);
+            return;
+        }
+
+        const bool drawBaked = toEnum<tileRenderMode>(g_tileRenderMode) == tileRenderMode::BAKED;
+
+        // Baked chunks are premultiplied, so their tint has to be as well
+        const Color bakedColor = {
+            static_cast<unsigned char>(job.color.r * job.color.a / 255),
+            static_cast<unsigned char>(job.color.g * job.color.a / 255),
+            static_cast<unsigned char>(job.color.b * job.color.a / 255),
+            job.color.a};
+
+        for (int cy = range.minY; cy <= range.maxY; cy++) {
+            for (int cx = range.minX; cx <= range.maxX; cx++) {
+                const std::size_t chunk = static_cast<std::size_t>(cy) * layerData.chunksX + cx;
+
+                // Chunks that didn't fit in the VRAM budget fall back to drawing per tile
+                if (drawBaked && layerData.bakedChunks[chunk].isBaked) {
+                    const Texture2D& chunkTexture = layerData.bakedChunks[chunk].target.texture;
+
+                    job.queue.drawTexture(
+                        job.pass,
+                        job.depth,
+                        chunkTexture,
+                        {
+                            0.0f,
+                            0.0f,
+                            static_cast<float>(chunkTexture.width),
+                            static_cast<float>(-chunkTexture.height)},
+                        getChunkOrigin(layerData, chunk) + adjustedOffset,
+                        bakedColor,
+                        nullptr,
+                        BLEND_ALPHA_PREMULTIPLY);
+
+                    job.stats.drawnChunks++;
+                    continue;
+                }
+
+                drawChunkTiles(job, chunk, layerView, adjustedOffset);
+            }
+        }
+
+        // Only safe to point into the vertices once they're done growing
+        for (const auto& run : job.runs) {
+            job.queue.drawQuads(
+                job.pass,
+                job.depth,
+                *run.texture,
+                job.vertices.data() + static_cast<std::size_t>(run.firstQuad) * 4,
+                run.quadCount,
+                {0.0f, 0.0f},
+                job.color);
+        }
+    }
+
+    // Repeating layers are drawn as one quad spanning only the visible copies, the texture
+    // wraps so UVs past 1.0 pick up the next copy.
+    static void renderImageLayer(
+        RenderQueue& queue,
+        const drawPass pass,
+        const std::uint16_t depth,
+        const SceneCamera& cam,
+        const renderPassEntry& entry,
+        const Vector2 adjustedOffset,
+        const Color color)
+    {
+        const Rectangle layerView = getLayerView(cam, adjustedOffset);
+        const float imageWidth = entry.sourceRect.width;
+        const float imageHeight = entry.sourceRect.height;
+
+        Rectangle source = entry.sourceRect;
+        Vector2 position = {0.0f, 0.0f};
+
+        if (entry.repeatX) {
+            const float firstCopy = std::floor(layerView.x / imageWidth);
+            const float lastCopy = std::floor((layerView.x + layerView.width) / imageWidth);
+
+            position.x = firstCopy * imageWidth;
+            source.width = (lastCopy - firstCopy + 1.0f) * imageWidth;
+        }
+
+        if (entry.repeatY) {
+            const float firstCopy = std::floor(layerView.y / imageHeight);
+            const float lastCopy = std::floor((layerView.y + layerView.height) / imageHeight);
+
+            position.y = firstCopy * imageHeight;
+            source.height = (lastCopy - firstCopy + 1.0f) * imageHeight;
+        }
+
+        if (!CheckCollisionRecs({position.x, position.y, source.width, source.height}, layerView)) return;
+
+        // Snap to whole pixels like DrawTexture does, otherwise the layer shimmers while scrolling
+        position += adjustedOffset;
+        position = {std::trunc(position.x), std::trunc(position.y)};
+
+        queue.drawTexture(pass, depth, *entry.texture, source, position, color);
+
+        s_tileStats.drawnImageCopies +=
+            static_cast<std::size_t>(source.width / imageWidth) * static_cast<std::size_t>(source.height / imageHeight);
+    }
+
+    static void addTileStats(const tileRenderStats& stats) noexcept {
+        s_tileStats.visitedTiles += stats.visitedTiles;
+        s_tileStats.culledTiles += stats.culledTiles;
+        s_tileStats.drawnTiles += stats.drawnTiles;
+        s_tileStats.totalTiles += stats.totalTiles;
+        s_tileStats.drawnChunks += stats.drawnChunks;
+    }
+
     static void renderLayerGroup(
+        RenderQueue& queue,
+        TaskScheduler& scheduler,
         const SceneCamera& cam,
         const MapData& map,
         const Vector2 offset,
         const Color color,
         const renderPassType mode)
     {
-        for (auto& layer : map.tsonMapPtr->getLayers()) {
-            if (layer.getClassType() == "DifferedLayer" && mode == renderPassType::PRIMARY_PASS) continue;
-            if (layer.getClassType() == "PrimaryLayer" && mode == renderPassType::DIFFERED_PASS) continue;
+        const bool isPrimary = mode == renderPassType::PRIMARY_PASS;
+        const drawPass passKind = isPrimary ? drawPass::BACKGROUND : drawPass::FOREGROUND;
+        const std::vector<renderPassEntry>& pass = isPrimary ?
+            map.renderDataPtr->primaryPass :
+            map.renderDataPtr->differedPass;
+
+        // Kept per pass and reused, their vertices have to outlive the queue's next flush()
+        std::vector<tileLayerJob>& jobs = s_layerJobs[static_cast<std::size_t>(mode)];
+        std::size_t jobCount = 0;
+
+        const std::size_t allocsBefore = getHeapAllocCount();
+
+        // Each layer gets its own depth, so only draws within the same layer get reordered
+        for (std::size_t i = 0; i < pass.size(); i++) {
+            const renderPassEntry& entry = pass[i];
+            const Color tint = ColorTint(color, entry.tint);
+            const auto depth = static_cast<std::uint16_t>(i);
+
+            switch (entry.kind) {
+                case mapLayerKind::TILE_LAYER: {
+                    forEachLayerData(*map.renderDataPtr, entry.tileLayerIndex, [&](TileLayerData& layerData) {
+                        if (jobCount == jobs.size()) jobs.emplace_back();
+
+                        tileLayerJob& job = jobs[jobCount++];
+                        job.entry = &entry;
+                        job.layerData = &layerData;
+                        job.offset = offset;
+                        job.color = tint;
+                        job.pass = passKind;
+                        job.depth = depth;
+                    });
+                    break;
+                }
+                case mapLayerKind::IMAGE_LAYER: {
+                    // A single quad, not worth a task
+                    renderImageLayer(queue, passKind, depth, cam, entry, getLayerDrawOffset(cam, entry, offset), tint);
+                    break;
+                }
+                default: {
+                    logFatal("Render pass contains unsupported layer kind: renderLayerGroup(Args...)");
+                    break;
+                }
+            }
+        }
+
+        scheduler.parallelFor(jobCount, 1, [&](const std::size_t begin, const std::size_t end) {
+            for (std::size_t i = begin; i < end; i++) {
+                renderTileLayer(cam, jobs[i]);
+            }
+        });
 
-            renderLayer(cam, map, layer, offset, color);
+        // Merged in pass order, so the queue's sort sees the same input whichever worker finished first
+        for (std::size_t i = 0; i < jobCount; i++) {
+            queue.append(jobs[i].queue);
+            addTileStats(jobs[i].stats);
         }
+
+        s_tileStats.heapAllocations += getHeapAllocCount() - allocsBefore;
     }
 
     // Don't need these, but it makes intentions clearer IMO
     void renderBackgroundLayers(
+        RenderQueue& queue,
+        TaskScheduler& scheduler,
         const SceneCamera& cam,
         const MapData& map,
         const Vector2 offset,
         const Color color)
     {
-        renderLayerGroup(cam, map, offset, color, renderPassType::PRIMARY_PASS);
+        renderLayerGroup(queue, scheduler, cam, map, offset, color, renderPassType::PRIMARY_PASS);
     }
 
     void renderForegroundLayers(
+        RenderQueue& queue,
+        TaskScheduler& scheduler,
         const SceneCamera& cam,
         const MapData &map,
         const Vector2 offset,
         const Color color)
     {
-        renderLayerGroup(cam, map, offset, color, renderPassType::DIFFERED_PASS);
+        renderLayerGroup(queue, scheduler, cam, map, offset, color, renderPassType::DIFFERED_PASS);
+    }
+
+    void updateTileCache(
+        const SceneCamera& cam,
+        const MapData& map,
+        const Vector2 offset)
+    {
+        RenderData& renderData = *map.renderDataPtr;
+        renderData.frameCounter++;
+
+        if (toEnum<tileRenderMode>(g_tileRenderMode) != tileRenderMode::BAKED) return;
+
+        // Touch every visible chunk first so none of them get evicted to make room for another
+        for (const auto* pass : {&renderData.primaryPass, &renderData.differedPass}) {
+            for (const auto& entry : *pass) {
+                if (entry.kind != mapLayerKind::TILE_LAYER) continue;
+
+                const Rectangle view = getLayerView(cam, getLayerDrawOffset(cam, entry, offset));
+
+                forEachLayerData(renderData, entry.tileLayerIndex, [&](TileLayerData& layerData) {
+                    const chunkRange range = getVisibleChunks(layerData, view);
+
+                    for (int cy = range.minY; cy <= range.maxY; cy++) {
+                        for (int cx = range.minX; cx <= range.maxX; cx++) {
+                            layerData.bakedChunks[static_cast<std::size_t>(cy) * layerData.chunksX + cx]
+                                .lastUsedFrame = renderData.frameCounter;
+                        }
+                    }
+                });
+            }
+        }
+
+        // Static layers only need baking once, so do it lazily the first time a chunk comes into view
+        const auto bakeVisibleChunks = [&](TileLayerData& layerData) {
+            const std::size_t chunkBytes = getBakedChunkBytes(layerData);
+
+            for (std::size_t chunk = 0; chunk < layerData.bakedChunks.size(); chunk++) {
+                const bakedChunk& baked = layerData.bakedChunks[chunk];
+
+                if (baked.isBaked || baked.lastUsedFrame != renderData.frameCounter) continue;
+                if (layerData.chunkStarts[chunk] == layerData.chunkStarts[chunk + 1]) continue;
+
+                bool hasRoom = true;
+                while (renderData.bakedChunkBytes + chunkBytes > g_bakedChunkBudgetBytes) {
+                    if (!evictBakedChunk(cam, map, offset)) {
+                        hasRoom = false;
+                        break;
+                    }
+                }
+
+                if (hasRoom) bakeChunk(renderData, layerData, chunk);
+            }
+        };
+
+        for (auto& layerData : renderData.tileLayers) {
+            bakeVisibleChunks(layerData);
+        }
+
+        for (auto& regionLayers : std::views::values(renderData.streamedTileLayers)) {
+            for (auto& layerData : regionLayers) {
+                bakeVisibleChunks(layerData);
+            }
+        }
+
+        s_tileStats.bakedChunkBytes = renderData.bakedChunkBytes;
+    }
+
+    void resetTileRenderStats() noexcept {
+        s_tileStats = {};
+    }
+
+    [[nodiscard]] const tileRenderStats& getTileRenderStats() noexcept {
+        return s_tileStats;
     }
 }
\ No newline at end of file
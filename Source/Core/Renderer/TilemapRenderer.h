@@ -9,43 +9,90 @@
 //
 // Module purpose/description:
 //
-// Function declarations for map rendering. Includes static functions that
-// are called in the main rendering function, and wrapper functions that
-// are used externally to perform draw calls on a MapData object.
+// Function declarations for map rendering. The wrapper functions here are
+// used externally to perform draw calls on a MapData object, the helpers they
+// call are kept static in TilemapRenderer.cpp.
 
 #ifndef TILEMAPRENDERER_H
 #define TILEMAPRENDERER_H
 
+#include <vector>
 #include "raylib.h"
+#include "../Backend/TaskScheduler.h"
 #include "../Camera/Camera.h"
+#include "../Renderer/RenderQueue.h"
 #include "../Renderer/Tilemap.h"
 
 namespace RE::Core {
-    static void renderLayer(
-        const SceneCamera& cam,
-        const MapData& map,
-        const tson::Layer& layer,
-        Vector2 offset,
-        Color color);
+    // Per-frame tile counters, used to confirm culling work scales with what's on screen.
+    struct tileRenderStats {
+        std::size_t visitedTiles{};  // Tiles inside chunks that overlapped the camera
+        std::size_t culledTiles{};   // Visited tiles that still fell outside the camera
+        std::size_t drawnTiles{};
+        std::size_t totalTiles{};    // Every tile in every tile layer that was submitted this frame
+        std::size_t drawnChunks{};   // Baked chunks drawn in place of their tiles
+        std::size_t bakedChunkBytes{};
+        std::size_t drawnImageCopies{}; // Copies of image layers covered, repeats included
+        std::size_t heapAllocations{}; // Main thread allocations made while rendering the map, debug builds only
+    };
 
-    static void renderLayerGroup(
-        const SceneCamera& cam,
-        const MapData& map,
-        Vector2 offset,
-        Color color,
-        renderPassType mode);
+    // Inclusive range of chunk coordinates. Empty when max < min.
+    struct chunkRange {
+        int minX;
+        int minY;
+        int maxX;
+        int maxY;
+    };
 
+    // Run of consecutive quads in a tileLayerJob that share a texture
+    struct quadRun {
+        const Texture2D* texture;
+        std::uint32_t firstQuad;
+        std::uint32_t quadCount;
+    };
+
+    // One tile layer's worth of work for a render worker. Everything the worker writes lives here,
+    // the main thread merges it into the real queue and stats once every worker is done.
+    struct tileLayerJob {
+        const renderPassEntry* entry;
+        TileLayerData* layerData;
+        Vector2 offset;
+        Color color;
+        drawPass pass;
+        std::uint16_t depth;
+        RenderQueue queue;
+        std::vector<tileVertex> vertices;   // Culled per tile quads, already in draw space
+        std::vector<quadRun> runs;
+        tileRenderStats stats;
+    };
+
+    // Records the layers into queue, they're drawn on its next flush(). Tile layers are culled and
+    // turned into quads on the scheduler's workers, one layer per task, so they finish sooner on more cores.
     void renderBackgroundLayers(
+        RenderQueue& queue,
+        TaskScheduler& scheduler,
         const SceneCamera& cam,
         const MapData& map,
         Vector2 offset,
         Color color);
 
     void renderForegroundLayers(
+        RenderQueue& queue,
+        TaskScheduler& scheduler,
         const SceneCamera& cam,
         const MapData& map,
         Vector2 offset,
         Color color);
+
+    // Bakes newly visible tile chunks and evicts stale ones when tileRenderMode::BAKED is active.
+    // Must be called once per frame, before any texture mode is entered.
+    void updateTileCache(
+        const SceneCamera& cam,
+        const MapData& map,
+        Vector2 offset);
+
+    void resetTileRenderStats() noexcept;
+    [[nodiscard]] const tileRenderStats& getTileRenderStats() noexcept;
 }
 
 #endif //TILEMAPRENDERER_H
@@ -0,0 +1,488 @@
+//
+// Author: DirgeWuff
+// Created on: 10/18/26
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Module purpose/description:
+//
+// Function definitions for WorldStreamer.h
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include "box2d/box2d.h"
+#include "WorldStreamer.h"
+#include "../Backend/Program.h"
+#include "../Utility/Globals.h"
+#include "../Utility/Logging.h"
+
+namespace RE::Core {
+    constexpr std::size_t g_notStreamed = std::numeric_limits<std::size_t>::max();
+
+    // Region coordinates are signed, tiles can sit left of or above the map origin
+    static std::uint64_t makeRegionKey(const int x, const int y) {
+        return static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 32 | static_cast<std::uint32_t>(y);
+    }
+
+    static int getRegionX(const std::uint64_t key) {
+        return static_cast<std::int32_t>(key >> 32);
+    }
+
+    static int getRegionY(const std::uint64_t key) {
+        return static_cast<std::int32_t>(key & 0xFFFFFFFF);
+    }
+
+    static int getRegionDistance(const std::uint64_t a, const std::uint64_t b) {
+        return std::max(std::abs(getRegionX(a) - getRegionX(b)), std::abs(getRegionY(a) - getRegionY(b)));
+    }
+
+    static fs::path getBinaryMapPath(const MapData& map) {
+        fs::path binaryPath = map.fullMapPath;
+        return binaryPath.replace_extension(".rmap");
+    }
+
+    WorldStreamer::WorldStreamer(const MapData& map, const b2WorldId world) :
+        m_file(getBinaryMapPath(map)),
+        m_renderData(map.renderDataPtr),
+        m_world(world),
+        m_regionSizePx{
+            static_cast<float>(g_streamRegionSize * map.tileWidth),
+            static_cast<float>(g_streamRegionSize * map.tileHeight)},
+        m_chunkSizePx(getTileChunkSize(map))
+    {
+        if (!viewBinaryMap(m_file, getBinaryMapPath(map), m_view, m_error)) {
+            logFatal(m_error + ". WorldStreamer::WorldStreamer(Args...)");
+            return;
+        }
+
+        // MapLoader already uploaded every texture in the file, they just need finding again
+        bool isValid = true;
+
+        for (const auto& texture : m_view.textures) {
+            const std::string_view relativePath = getRmapString(m_view.strings, texture.path, isValid);
+            const std::string path = map.baseDir.string() + std::string(relativePath);
+
+            if (!isValid) {
+                logFatal("Streamed map contains an invalid texture path. WorldStreamer::WorldStreamer(Args...)");
+                return;
+            }
+
+            const atlasRegion* region = m_renderData->atlas ? m_renderData->atlas->findRegion(path) : nullptr;
+
+            if (region) {
+                m_textureRegions.push_back(*region);
+            }
+            else if (const auto it = m_renderData->textures.find(path); it != m_renderData->textures.end()) {
+                m_textureRegions.push_back({
+                    &it->second,
+                    {0.0f, 0.0f, static_cast<float>(it->second.width), static_cast<float>(it->second.height)}});
+            }
+            else {
+                logFatal("Streamed map texture was never loaded: " + path + ". WorldStreamer::WorldStreamer(Args...)");
+                return;
+            }
+        }
+
+        // Tile layers are numbered in file order, same as when the map was staged
+        for (const auto& layer : m_view.layers) {
+            if (static_cast<mapLayerKind>(layer.kind) != mapLayerKind::TILE_LAYER) {
+                m_tileLayerIndices.push_back(g_notStreamed);
+                continue;
+            }
+
+            renderPassEntry entry{};
+            entry.kind = mapLayerKind::TILE_LAYER;
+            entry.parallax = {layer.parallaxX, layer.parallaxY};
+
+            m_tileLayerIndices.push_back(isStreamedLayer(entry) ? m_tileLayerCount : g_notStreamed);
+            m_tileLayerCount++;
+        }
+
+        // The worker has m_sources and m_error to itself until the task is done
+        m_indexTask = Program::getInstance().getScheduler().schedule([this] {
+            m_isIndexBuilt = buildIndex();
+        });
+    }
+
+    WorldStreamer::~WorldStreamer() {
+        // Can't free anything a worker is still reading
+        TaskScheduler::blockUntilDone(m_indexTask);
+
+        for (auto& [key, region] : m_regions) {
+            TaskScheduler::blockUntilDone(region.tileTask);
+            unloadRegion(key, region);
+        }
+    }
+
+    [[nodiscard]] std::uint64_t WorldStreamer::getRegionKey(const Vector2 positionPx) const noexcept {
+        return makeRegionKey(
+            static_cast<int>(std::floor(positionPx.x / m_regionSizePx.x)),
+            static_cast<int>(std::floor(positionPx.y / m_regionSizePx.y)));
+    }
+
+    bool WorldStreamer::buildIndex() {
+        // Tiles go to the region holding the origin of their chunk
+        for (std::size_t i = 0; i < m_view.layers.size(); i++) {
+            if (m_tileLayerIndices[i] == g_notStreamed) continue;
+
+            const rmapLayer& layer = m_view.layers[i];
+            if (!isValidTileLayer(m_view, layer)) {
+                m_error = "Streamed map contains out of range tile indices";
+                return false;
+            }
+
+            const auto chunkStarts = m_view.chunkStarts.subspan(
+                layer.firstChunk,
+                static_cast<std::size_t>(layer.chunksX) * layer.chunksY + 1);
+
+            for (std::size_t chunk = 0; chunk + 1 < chunkStarts.size(); chunk++) {
+                if (chunkStarts[chunk] == chunkStarts[chunk + 1]) continue;
+
+                const Vector2 chunkOrigin = {
+                    layer.gridOriginX + static_cast<float>(chunk % layer.chunksX) * layer.chunkWidth,
+                    layer.gridOriginY + static_cast<float>(chunk / layer.chunksX) * layer.chunkHeight};
+
+                m_sources[getRegionKey(chunkOrigin)].hasTiles = true;
+            }
+        }
+
+        // Polylines are cut into one piece per run of segments whose midpoints share a region.
+        // Box2D only collides segments 1 to count - 3 of an open chain, the first and last are
+        // ghosts, so each piece takes one extra vertex either side of its run.
+        for (const auto& polyline : m_view.polylines) {
+            if (polyline.firstVertex > m_view.vertices.size() ||
+                polyline.vertexCount > m_view.vertices.size() - polyline.firstVertex ||
+                polyline.vertexCount < 4)
+            {
+                m_error = "Streamed map contains an invalid collision polyline";
+                return false;
+            }
+
+            const b2Vec2* points = m_view.vertices.data() + polyline.firstVertex;
+            const auto getSegmentKey = [this, points](const std::uint32_t segment) {
+                const b2Vec2 midpoint = b2MulSV(0.5f, b2Add(points[segment], points[segment + 1]));
+                return getRegionKey(metersToPixelsVec(midpoint));
+            };
+
+            const std::uint32_t lastSegment = polyline.vertexCount - 3;
+            std::uint32_t runStart = 1;
+            std::uint64_t runKey = getSegmentKey(runStart);
+
+            for (std::uint32_t segment = 2; segment <= lastSegment + 1; segment++) {
+                if (segment <= lastSegment && getSegmentKey(segment) == runKey) continue;
+
+                m_sources[runKey].polylines.push_back({
+                    polyline.firstVertex + runStart - 1,
+                    segment - runStart + 3});
+
+                if (segment <= lastSegment) {
+                    runStart = segment;
+                    runKey = getSegmentKey(segment);
+                }
+            }
+        }
+
+        for (std::uint32_t i = 0; i < m_view.eventColliders.size(); i++) {
+            const rmapEventCollider& collider = m_view.eventColliders[i];
+
+            if (collider.type >= static_cast<std::uint8_t>(sensorType::COUNT)) {
+                m_error = "Streamed map contains an unknown event collider type";
+                return false;
+            }
+
+            m_sources[getRegionKey({collider.x + collider.width / 2.0f, collider.y + collider.height / 2.0f})]
+                .eventColliders.push_back(i);
+        }
+
+        return true;
+    }
+
+    // Runs on a worker thread. Only reads the mapped file and the texture regions.
+    [[nodiscard]] std::vector<TileLayerData> WorldStreamer::buildRegionTiles(const std::uint64_t key) const {
+        std::vector<TileLayerData> tileLayers(m_tileLayerCount);
+        const Rectangle bounds = getRegionBounds(key);
+        std::vector<TileData> unsortedTiles;
+
+        for (std::size_t i = 0; i < m_view.layers.size(); i++) {
+            if (m_tileLayerIndices[i] == g_notStreamed) continue;
+
+            const rmapLayer& layer = m_view.layers[i];
+            TileLayerData& layerData = tileLayers[m_tileLayerIndices[i]];
+            unsortedTiles.clear();
+
+            // Rough chunk range, widened by one and then checked exactly the same way buildIndex assigned them
+            const int firstX = std::max(static_cast<int>((bounds.x - layer.gridOriginX) / layer.chunkWidth) - 1, 0);
+            const int firstY = std::max(static_cast<int>((bounds.y - layer.gridOriginY) / layer.chunkHeight) - 1, 0);
+            const int lastX = std::min(
+                static_cast<int>((bounds.x + bounds.width - layer.gridOriginX) / layer.chunkWidth) + 1,
+                layer.chunksX - 1);
+            const int lastY = std::min(
+                static_cast<int>((bounds.y + bounds.height - layer.gridOriginY) / layer.chunkHeight) + 1,
+                layer.chunksY - 1);
+
+            for (int cy = firstY; cy <= lastY; cy++) {
+                for (int cx = firstX; cx <= lastX; cx++) {
+                    const Vector2 chunkOrigin = {
+                        layer.gridOriginX + static_cast<float>(cx) * layer.chunkWidth,
+                        layer.gridOriginY + static_cast<float>(cy) * layer.chunkHeight};
+
+                    if (getRegionKey(chunkOrigin) != key) continue;
+
+                    const std::size_t chunk = layer.firstChunk + static_cast<std::size_t>(cy) * layer.chunksX + cx;
+
+                    for (std::size_t t = layer.firstTile + m_view.chunkStarts[chunk];
+                         t < layer.firstTile + m_view.chunkStarts[chunk + 1];
+                         t++)
+                    {
+                        const atlasRegion& region = m_textureRegions[m_view.tileTexture[t]];
+
+                        unsortedTiles.push_back({
+                            {
+                                m_view.tileSrcX[t] + region.rect.x,
+                                m_view.tileSrcY[t] + region.rect.y,
+                                m_view.tileSrcWidth[t],
+                                m_view.tileSrcHeight[t]},
+                            {m_view.tilePosX[t], m_view.tilePosY[t]},
+                            region.texture});
+                    }
+                }
+            }
+
+            // Same as addTileLayer, minus adding it anywhere
+            bucketTileLayer(unsortedTiles, m_chunkSizePx, layerData);
+
+            if (!layerData.tiles.empty()) {
+                layerData.bakedChunks.resize(layerData.chunkStarts.size() - 1);
+                buildTileBatches(layerData);
+            }
+        }
+
+        return tileLayers;
+    }
+
+    bool WorldStreamer::createRegionPhysics(streamedRegion& region, const regionSource& source, const double deadline) {
+        region.eventColliders.reserve(source.eventColliders.size());
+
+        if (region.collisionObjects.size() == 0) {
+            std::size_t vertCount = 0;
+            for (const auto& piece : source.polylines) {
+                vertCount += piece.vertexCount;
+            }
+
+            region.collisionObjects.reserve(source.polylines.size(), vertCount);
+        }
+
+        while (region.collisionObjects.size() < source.polylines.size()) {
+            if (GetTime() >= deadline) return false;
+
+            const streamedPolyline& piece = source.polylines[region.collisionObjects.size()];
+            region.collisionObjects.addSpline(m_world, m_view.vertices.subspan(piece.firstVertex, piece.vertexCount));
+        }
+
+        while (region.eventColliders.size() < source.eventColliders.size()) {
+            if (GetTime() >= deadline) return false;
+
+            const std::uint32_t index = source.eventColliders[region.eventColliders.size()];
+            const rmapEventCollider& collider = m_view.eventColliders[index];
+
+            const EventCollider& created = region.eventColliders.emplace_back(
+                collider.x,
+                collider.y,
+                collider.width,
+                collider.height,
+                static_cast<sensorType>(collider.type),
+                m_world);
+
+            // Checkpoints that were already reached stay that way
+            if (m_disabledColliders.contains(index)) created.disableCollider();
+        }
+
+        // A chain created more than once leaves extra segments on the body
+        assert(region.collisionObjects.isShapeCountValid());
+
+        return true;
+    }
+
+    void WorldStreamer::unloadRegion(const std::uint64_t key, streamedRegion& region) {
+        if (region.state == regionState::LOADED) m_physicsVersion++;
+
+        region.collisionObjects.destroySplines();
+
+        for (auto& collider : region.eventColliders) {
+            collider.destroyCollider();
+        }
+
+        region.eventColliders.clear();
+
+        if (const auto it = m_renderData->streamedTileLayers.find(key); it != m_renderData->streamedTileLayers.end()) {
+            for (auto& layerData : it->second) {
+                unloadBakedChunks(layerData, *m_renderData);
+            }
+
+            m_renderData->streamedTileLayers.erase(it);
+        }
+
+        #ifdef DEBUG
+            logDbg("Streamed out region ", getRegionX(key), ", ", getRegionY(key));
+        #endif
+    }
+
+    void WorldStreamer::update(const Vector2 focusPx, const double budgetSeconds) {
+        const double deadline = GetTime() + budgetSeconds;
+
+        if (!m_isIndexed) {
+            // Null once a failed index has been reported
+            if (!m_indexTask || !TaskScheduler::isDone(m_indexTask)) return;
+
+            m_indexTask = nullptr;
+
+            if (!m_isIndexBuilt) {
+                logFatal(m_error + ". WorldStreamer::update(Args...)");
+                return;
+            }
+
+            m_isIndexed = true;
+
+            #ifdef DEBUG
+                logDbg("Streamed map indexed, ", m_sources.size(), " regions have content.");
+            #endif
+        }
+
+        const std::uint64_t focusKey = getRegionKey(focusPx);
+
+        // Unload first so the broadphase never holds more than the unload radius worth of regions.
+        // Regions still building on a worker are left until the worker is done with them.
+        for (auto it = m_regions.begin(); it != m_regions.end();) {
+            auto& [key, region] = *it;
+
+            const bool isBuilding = region.state == regionState::BUILDING && !TaskScheduler::isDone(region.tileTask);
+
+            if (getRegionDistance(key, focusKey) <= g_streamUnloadRadius || isBuilding) {
+                ++it;
+                continue;
+            }
+
+            unloadRegion(key, region);
+            it = m_regions.erase(it);
+        }
+
+        auto buildingCount = static_cast<std::size_t>(std::ranges::count_if(m_regions, [](const auto& pair) {
+            return pair.second.state == regionState::BUILDING;
+        }));
+
+        // Nearest regions first, in rings around the focus
+        for (int ring = 0; ring <= g_streamLoadRadius; ring++) {
+            for (int y = getRegionY(focusKey) - ring; y <= getRegionY(focusKey) + ring; y++) {
+                for (int x = getRegionX(focusKey) - ring; x <= getRegionX(focusKey) + ring; x++) {
+                    const std::uint64_t key = makeRegionKey(x, y);
+                    if (getRegionDistance(key, focusKey) != ring) continue;
+
+                    // Empty space never gets loaded
+                    const auto source = m_sources.find(key);
+                    if (source == m_sources.end()) continue;
+
+                    auto it = m_regions.find(key);
+                    if (it == m_regions.end()) {
+                        if (buildingCount >= g_streamMaxBuilding) continue;
+
+                        streamedRegion& region = m_regions[key];
+                        region.state = regionState::BUILDING;
+                        region.tileTask = Program::getInstance().getScheduler().schedule([this, key, &region] {
+                            region.tileLayers = buildRegionTiles(key);
+                        });
+
+                        buildingCount++;
+                        continue;
+                    }
+
+                    streamedRegion& region = it->second;
+
+                    if (region.state == regionState::BUILDING) {
+                        if (!TaskScheduler::isDone(region.tileTask)) continue;
+
+                        region.tileTask = nullptr;
+                        region.state = regionState::CREATING_PHYSICS;
+                        buildingCount--;
+                    }
+
+                    if (region.state == regionState::CREATING_PHYSICS &&
+                        createRegionPhysics(region, source->second, deadline))
+                    {
+                        // Tiles show up together with the ground they draw
+                        if (source->second.hasTiles) {
+                            m_renderData->streamedTileLayers.emplace(key, std::move(region.tileLayers));
+                        }
+
+                        region.tileLayers.clear();
+                        region.state = regionState::LOADED;
+                        m_physicsVersion++;
+
+                        #ifdef DEBUG
+                            logDbg("Streamed in region ", x, ", ", y);
+                        #endif
+                    }
+                }
+            }
+        }
+    }
+
+    [[nodiscard]] bool WorldStreamer::isLoadedAround(const Vector2 focusPx) const {
+        if (!m_isIndexed) return false;
+
+        const std::uint64_t focusKey = getRegionKey(focusPx);
+
+        for (int y = getRegionY(focusKey) - g_streamLoadRadius; y <= getRegionY(focusKey) + g_streamLoadRadius; y++) {
+            for (int x = getRegionX(focusKey) - g_streamLoadRadius; x <= getRegionX(focusKey) + g_streamLoadRadius; x++) {
+                const std::uint64_t key = makeRegionKey(x, y);
+                if (!m_sources.contains(key)) continue;
+
+                const auto it = m_regions.find(key);
+                if (it == m_regions.end() || it->second.state != regionState::LOADED) return false;
+            }
+        }
+
+        return true;
+    }
+
+    [[nodiscard]] bool WorldStreamer::isBusy() const {
+        if (!TaskScheduler::isDone(m_indexTask)) return true;
+
+        return std::ranges::any_of(m_regions, [](const auto& entry) {
+            return !TaskScheduler::isDone(entry.second.tileTask);
+        });
+    }
+
+    void WorldStreamer::disableEventCollider(const guid& colliderGuid) {
+        for (const auto& [key, region] : m_regions) {
+            const regionSource& source = m_sources.at(key);
+
+            for (std::size_t i = 0; i < region.eventColliders.size(); i++) {
+                if (region.eventColliders[i].getSensorInfo().id == colliderGuid) {
+                    region.eventColliders[i].disableCollider();
+                    m_disabledColliders.insert(source.eventColliders[i]);
+                }
+            }
+        }
+    }
+
+    [[nodiscard]] const std::unordered_map<std::uint64_t, streamedRegion>& WorldStreamer::getRegions() const noexcept {
+        return m_regions;
+    }
+
+    [[nodiscard]] std::uint64_t WorldStreamer::getPhysicsVersion() const noexcept {
+        return m_physicsVersion;
+    }
+
+    [[nodiscard]] Rectangle WorldStreamer::getRegionBounds(const std::uint64_t key) const noexcept {
+        return {
+            static_cast<float>(getRegionX(key)) * m_regionSizePx.x,
+            static_cast<float>(getRegionY(key)) * m_regionSizePx.y,
+            m_regionSizePx.x,
+            m_regionSizePx.y};
+    }
+}
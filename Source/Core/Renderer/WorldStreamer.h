@@ -0,0 +1,116 @@
+//
+// Author: DirgeWuff
+// Created on: 10/18/26
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Module purpose/description:
+//
+// Class declaration for WorldStreamer, which keeps only the part of a streamed
+// map around the camera loaded. The world is split into square regions of
+// g_streamRegionSize tiles. Tile layers for a region are built on a worker
+// thread straight out of the memory mapped .rmap, then its collision chains
+// and sensors are created on the main thread a few per frame. Regions that
+// fall far enough behind are destroyed again, so memory use and the number of
+// bodies in the Box2D broadphase depend on the view, not on the map size.
+//
+// Maps opt in with a bool "streamed" property. Everything else about the map,
+// textures, image layers and parallax tile layers, is loaded up front by
+// MapLoader as usual.
+
+#ifndef WORLDSTREAMER_H
+#define WORLDSTREAMER_H
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "Tilemap.h"
+#include "../Backend/TaskScheduler.h"
+#include "../Serialization/BinaryMap.h"
+#include "../Utility/MappedFile.h"
+
+namespace RE::Core {
+    // Part of one of the map's polylines. Pieces of the same polyline overlap by one segment
+    // at each end, which Box2D uses as ghost vertices, so the player can't snag on the seams.
+    struct streamedPolyline {
+        std::uint32_t firstVertex;
+        std::uint32_t vertexCount;
+    };
+
+    // Collision and sensors for one region, as indices into the .rmap. Tiles aren't listed,
+    // they're found through each layer's chunk grid.
+    struct regionSource {
+        std::vector<streamedPolyline> polylines;
+        std::vector<std::uint32_t> eventColliders;
+        bool hasTiles;
+    };
+
+    struct streamedRegion {
+        TaskScheduler::taskHandle tileTask;                 // Building on a worker
+        std::vector<TileLayerData> tileLayers;              // Filled by tileTask, moved into RenderData with physics
+        CollisionStore collisionObjects;
+        std::vector<EventCollider> eventColliders;          // Same order as regionSource::eventColliders
+        regionState state;
+    };
+
+    class WorldStreamer {
+        MappedFile m_file;
+        rmapView m_view{};
+        std::shared_ptr<RenderData> m_renderData{};
+        b2WorldId m_world{};
+        std::vector<atlasRegion> m_textureRegions{}; // One per .rmap texture
+        std::vector<std::size_t> m_tileLayerIndices{}; // Per .rmap layer, SIZE_MAX if it isn't streamed
+        std::size_t m_tileLayerCount{};
+        TaskScheduler::taskHandle m_indexTask{};
+        std::unordered_map<std::uint64_t, regionSource> m_sources{}; // Owned by the worker until m_indexTask is done
+        std::unordered_map<std::uint64_t, streamedRegion> m_regions{};
+        std::unordered_set<std::uint32_t> m_disabledColliders{};
+        std::string m_error{};
+        std::uint64_t m_physicsVersion{};
+        Vector2 m_regionSizePx{};
+        Vector2 m_chunkSizePx{};
+        bool m_isIndexBuilt{};    // buildIndex()'s result, set by the worker
+        bool m_isIndexed{};
+
+        [[nodiscard]] std::uint64_t getRegionKey(Vector2 positionPx) const noexcept;
+        bool buildIndex();
+        [[nodiscard]] std::vector<TileLayerData> buildRegionTiles(std::uint64_t key) const;
+        bool createRegionPhysics(streamedRegion& region, const regionSource& source, double deadline);
+        void unloadRegion(std::uint64_t key, streamedRegion& region);
+    public:
+        WorldStreamer(const MapData& map, b2WorldId world);
+        ~WorldStreamer();
+
+        WorldStreamer(const WorldStreamer&) = delete;
+        WorldStreamer(WorldStreamer&&) = delete;
+        WorldStreamer& operator=(const WorldStreamer&) = delete;
+        WorldStreamer& operator=(WorldStreamer&&) = delete;
+
+        // Loads regions coming into range of focusPx and destroys ones that have fallen out of it.
+        // Main thread only, call once per frame. Spends at most budgetSeconds creating Box2D objects.
+        void update(Vector2 focusPx, double budgetSeconds);
+
+        // True once every region within g_streamLoadRadius of focusPx is fully loaded
+        [[nodiscard]] bool isLoadedAround(Vector2 focusPx) const;
+
+        // True while a worker is still indexing the map or building a region. Destroying the streamer until
+        // then blocks on them.
+        [[nodiscard]] bool isBusy() const;
+
+        // Disables the sensor, and keeps it disabled if its region is unloaded and loaded again
+        void disableEventCollider(const guid& colliderGuid);
+
+        [[nodiscard]] const std::unordered_map<std::uint64_t, streamedRegion>& getRegions() const noexcept;
+        [[nodiscard]] Rectangle getRegionBounds(std::uint64_t key) const noexcept;
+
+        // Changes whenever a region's collision is created or destroyed
+        [[nodiscard]] std::uint64_t getPhysicsVersion() const noexcept;
+    };
+}
+
+#endif //WORLDSTREAMER_H
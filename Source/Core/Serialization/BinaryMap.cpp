@@ -0,0 +1,1043 @@
+//
+// Author: DirgeWuff
+// Created on: 10/18/26
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Module purpose/description:
+//
+// Function definitions for BinaryMap.h, plus the .rmap loader declared in
+// Tilemap.h and a benchmark comparing it against loading the .tmj.
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+#include "ranges"
+#include "box2d/box2d.h"
+#include "BinaryMap.h"
+#include "../Renderer/Tilemap.h"
+#include "../Utility/Globals.h"
+#include "../Utility/Logging.h"
+#include "../Utility/MappedFile.h"
+#include "../Utility/Utils.h"
+
+namespace RE::Core {
+    // Writing
+    // =================================================================================================================
+    template<typename T>
+    static rmapSection appendSection(std::vector<std::byte>& buffer, const std::vector<T>& data) {
+        // Every section starts 8 byte aligned so it can be read in place once mapped
+        buffer.resize((buffer.size() + 7) & ~static_cast<std::size_t>(7));
+
+        const rmapSection section = {buffer.size(), data.size()};
+        buffer.resize(buffer.size() + data.size() * sizeof(T));
+
+        if (!data.empty()) {
+            std::memcpy(buffer.data() + section.offset, data.data(), data.size() * sizeof(T));
+        }
+
+        return section;
+    }
+
+    // Paths of the external tilesets a Tiled map uses. tson::Map doesn't keep them, so they're read from the .tmj.
+    static std::vector<fs::path> getExternalTilesets(const fs::path& tiledMapPath) {
+        std::vector<fs::path> tilesets;
+        tson::Json11 json;
+
+        if (!json.parse(tiledMapPath) || json.count("tilesets") == 0) return tilesets;
+
+        for (const auto& tileset : json["tilesets"].array()) {
+            if (tileset->count("source") == 0) continue;
+
+            tilesets.push_back(tiledMapPath.parent_path() / (*tileset)["source"].get<std::string>());
+        }
+
+        return tilesets;
+    }
+
+    [[nodiscard]] std::vector<std::string> validateTiledMap(tson::Map& map, const fs::path& mapDir) {
+        std::vector<std::string> problems;
+
+        const auto checkImage = [&problems, &mapDir](const fs::path& imagePath, const std::string& usedBy) {
+            std::error_code ec;
+
+            if (imagePath.empty() || !fs::is_regular_file(mapDir / imagePath, ec)) {
+                problems.push_back("Missing image \"" + imagePath.string() + "\" used by " + usedBy);
+            }
+        };
+
+        for (const auto& tileset : map.getTilesets()) {
+            checkImage(tileset.getImage(), "tileset \"" + tileset.getName() + "\"");
+        }
+
+        for (auto& layer : map.getLayers()) {
+            const std::string layerName = "layer \"" + layer.getName() + "\"";
+
+            if (layer.getType() == tson::LayerType::TileLayer) {
+                continue;
+            }
+
+            if (layer.getType() == tson::LayerType::ImageLayer) {
+                checkImage(layer.getImage(), "image " + layerName);
+            }
+            else if (layer.getType() == tson::LayerType::ObjectGroup && layer.getName() == "Collision mesh") {
+                for (auto& object : layer.getObjects()) {
+                    if (object.getObjectType() != tson::ObjectType::Polyline) {
+                        problems.push_back("Object " + std::to_string(object.getId()) + " in " + layerName +
+                            " is not a polyline");
+                    }
+                    else if (object.getPolylines().size() < 4) {
+                        problems.push_back("Polyline " + std::to_string(object.getId()) + " in " + layerName +
+                            " has fewer than 4 points, Box2D chains need at least 4");
+                    }
+                }
+            }
+            else if (layer.getType() == tson::LayerType::ObjectGroup && layer.getName() == "Event colliders") {
+                for (auto& object : layer.getObjects()) {
+                    if (object.getName() == "MapExit") {
+                        mapExit exit{};
+                        std::string exitError;
+                        std::error_code ec;
+
+                        if (!readMapExit(object, mapDir, exit, exitError)) {
+                            problems.push_back(exitError + " in " + layerName);
+                        }
+                        else if (!fs::is_regular_file(exit.targetMap, ec)) {
+                            problems.push_back("MapExit " + std::to_string(object.getId()) + " in " + layerName +
+                                " leads to missing map \"" + exit.targetMap.string() + "\"");
+                        }
+                    }
+                    else if (object.getName() != "MurderBox" && object.getName() != "Checkpoint") {
+                        problems.push_back("Unknown event collider \"" + object.getName() + "\" in " + layerName +
+                            ", expected \"MurderBox\", \"Checkpoint\" or \"MapExit\"");
+                    }
+                }
+            }
+            else if (layer.getType() == tson::LayerType::ObjectGroup && layer.getName() == "Lights") {
+                for (auto& object : layer.getObjects()) {
+                    lightSource light{};
+                    std::string lightError;
+
+                    if (!readLight(object, light, lightError)) {
+                        problems.push_back(lightError + " in " + layerName);
+                    }
+                }
+            }
+            else if (layer.getType() == tson::LayerType::ObjectGroup) {
+                problems.push_back("Unknown object " + layerName +
+                    ", expected \"Collision mesh\", \"Event colliders\" or \"Lights\"");
+            }
+            else {
+                problems.push_back("Unsupported " + layerName + ", group layers can't be loaded");
+            }
+        }
+
+        tson::PropertyCollection& props = map.getProperties();
+
+        for (const char* propName : {"playerStartX", "playerStartY"}) {
+            if (!props.hasProperty(propName)) {
+                problems.push_back(std::string("Map has no property \"") + propName + "\"");
+            }
+            else if (props.getProperty(propName)->getType() != tson::Type::Float) {
+                problems.push_back(std::string("Map property \"") + propName + "\" must be a float");
+            }
+        }
+
+        if (!props.hasProperty("bgNoisePath")) {
+            problems.push_back("Map has no property \"bgNoisePath\"");
+        }
+        else if (props.getProperty("bgNoisePath")->getType() != tson::Type::String &&
+                 props.getProperty("bgNoisePath")->getType() != tson::Type::File)
+        {
+            problems.push_back("Map property \"bgNoisePath\" must be a string or file");
+        }
+
+        if (props.hasProperty("streamed") && props.getProperty("streamed")->getType() != tson::Type::Boolean) {
+            problems.push_back("Map property \"streamed\" must be a bool");
+        }
+
+        // MapData and the .rmap header keep these in 8 and 16 bits, and chunk and region sizes are multiples of them
+        const tson::Vector2i tileSize = map.getTileSize();
+        const tson::Vector2i mapSize = map.getSize();
+        constexpr int maxTileSize = std::numeric_limits<std::uint8_t>::max();
+        constexpr int maxMapSize = std::numeric_limits<std::uint16_t>::max();
+
+        if (tileSize.x < 1 || tileSize.y < 1 || tileSize.x > maxTileSize || tileSize.y > maxTileSize) {
+            problems.push_back(
+                "Map tile size must be 1 to " + std::to_string(maxTileSize) + " pixels, is " +
+                std::to_string(tileSize.x) + "x" + std::to_string(tileSize.y));
+        }
+
+        if (mapSize.x < 1 || mapSize.y < 1 || mapSize.x > maxMapSize || mapSize.y > maxMapSize) {
+            problems.push_back(
+                "Map size must be 1 to " + std::to_string(maxMapSize) + " tiles, is " +
+                std::to_string(mapSize.x) + "x" + std::to_string(mapSize.y));
+        }
+
+        return problems;
+    }
+
+    // An image referenced by the map, before atlas packing
+    struct rmapSourceImage {
+        std::string path; // Relative to the .tmj
+        bool repeats;
+        bool isUsed;
+    };
+
+    // Where a source image ended up. rect is its place in the packed atlas, or zero sized if it wasn't packed.
+    struct rmapImagePlacement {
+        std::uint32_t textureIndex;
+        Rectangle rect;
+    };
+
+    struct rmapPendingLayer {
+        rmapLayer layer;
+        TileLayerData tiles; // Tile layers only, already chunked
+        std::uint32_t image; // Image layers only, index into the source images
+    };
+
+    bool writeBinaryMap(
+        tson::Map& map,
+        const fs::path& tiledMapPath,
+        const fs::path& outputPath,
+        const rmapWriteOptions& options,
+        std::string& error)
+    {
+        const fs::path mapDir = tiledMapPath.parent_path();
+        rmapHeader header{};
+        std::vector<char> strings;
+        std::vector<rmapTexture> textures;
+        std::vector<rmapLayer> layers;
+        std::vector<float> tilePosX, tilePosY, tileSrcX, tileSrcY, tileSrcWidth, tileSrcHeight;
+        std::vector<std::uint32_t> tileTexture;
+        std::vector<std::uint32_t> chunkStarts;
+        std::vector<rmapPolyline> polylines;
+        std::vector<b2Vec2> vertices;
+        std::vector<rmapEventCollider> eventColliders;
+        std::vector<rmapMapExit> mapExits;
+        std::vector<fs::path> mapExitTargets; // Made relative to the output once its directory is known
+        std::vector<rmapLight> lights;
+        std::vector<rmapSource> sources;
+        std::vector<rmapSourceImage> images;
+        std::vector<rmapPendingLayer> pendingLayers;
+        std::unordered_map<const tson::Tileset*, std::uint32_t> tilesetImages;
+
+        const auto addString = [&strings](const std::string& str) {
+            const rmapString ref = {static_cast<std::uint32_t>(strings.size()), static_cast<std::uint32_t>(str.size())};
+            strings.insert(strings.end(), str.begin(), str.end());
+
+            return ref;
+        };
+
+        const auto addImage = [&images](const std::string& path, const bool repeats) {
+            const auto it = std::ranges::find(images, path, &rmapSourceImage::path);
+
+            if (it != images.end()) {
+                it->repeats |= repeats;
+                return static_cast<std::uint32_t>(it - images.begin());
+            }
+
+            images.push_back({path, repeats, false});
+            return static_cast<std::uint32_t>(images.size() - 1);
+        };
+
+        for (const auto& tileset : map.getTilesets()) {
+            tilesetImages[&tileset] = addImage(tileset.getImage().string(), false);
+        }
+
+        // Tiles point at one of these instead of a real texture, so they can be chunked by the same code
+        // the loader uses. The pointer is turned back into an image index once the atlas is packed.
+        const std::vector<Texture2D> tilesetPlaceholders(images.size());
+
+        const Vector2 chunkSizePx = {
+            static_cast<float>(map.getTileSize().x * g_tileChunkSize),
+            static_cast<float>(map.getTileSize().y * g_tileChunkSize)};
+
+        std::vector<TileData> unsortedTiles;
+        std::vector<b2Vec2> points;
+
+        for (auto& layer : map.getLayers()) {
+            const std::uint8_t passMask = getRenderPassMask(layer);
+            const renderPassEntry entry = makeRenderPassEntry(layer);
+
+            rmapPendingLayer outLayer{};
+            outLayer.layer.passMask = passMask;
+            outLayer.layer.repeatX = entry.repeatX;
+            outLayer.layer.repeatY = entry.repeatY;
+            outLayer.layer.tint[0] = entry.tint.r;
+            outLayer.layer.tint[1] = entry.tint.g;
+            outLayer.layer.tint[2] = entry.tint.b;
+            outLayer.layer.tint[3] = entry.tint.a;
+            outLayer.layer.parallaxX = entry.parallax.x;
+            outLayer.layer.parallaxY = entry.parallax.y;
+            outLayer.layer.offsetX = entry.offset.x;
+            outLayer.layer.offsetY = entry.offset.y;
+
+            if (layer.getType() == tson::LayerType::TileLayer) {
+                // Hidden layers never get drawn, no point storing their tiles
+                if (passMask == 0) continue;
+
+                outLayer.layer.kind = static_cast<std::uint8_t>(mapLayerKind::TILE_LAYER);
+                unsortedTiles.clear();
+
+                for (auto& tile : std::views::values(layer.getTileObjects())) {
+                    const auto it = tilesetImages.find(tile.getTile()->getTileset());
+
+                    if (it == tilesetImages.end()) {
+                        error = "Tile in layer \"" + layer.getName() + "\" references an unknown tileset";
+                        return false;
+                    }
+
+                    images[it->second].isUsed = true;
+                    unsortedTiles.push_back({
+                        toRayRect(tile.getDrawingRect()),
+                        toRayVec2(tile.getPosition()),
+                        &tilesetPlaceholders[it->second]});
+                }
+
+                bucketTileLayer(unsortedTiles, chunkSizePx, outLayer.tiles);
+                pendingLayers.push_back(std::move(outLayer));
+            }
+            else if (layer.getType() == tson::LayerType::ImageLayer) {
+                if (passMask == 0) continue;
+
+                outLayer.layer.kind = static_cast<std::uint8_t>(mapLayerKind::IMAGE_LAYER);
+                outLayer.image = addImage(layer.getImage(), entry.repeatX || entry.repeatY);
+                images[outLayer.image].isUsed = true;
+                pendingLayers.push_back(std::move(outLayer));
+            }
+            else if (layer.getType() == tson::LayerType::ObjectGroup && layer.getName() == "Collision mesh") {
+                for (auto& object : layer.getObjects()) {
+                    if (object.getObjectType() != tson::ObjectType::Polyline) {
+                        error = "Collision layer contains incompatible type";
+                        return false;
+                    }
+
+                    const tson::Vector2i pos = object.getPosition();
+                    points.clear();
+
+                    for (const auto& point : object.getPolylines()) {
+                        points.push_back(pixelsToMetersVec(v2iAdd(point, pos)));
+                    }
+
+                    if (options.simplifyCollision) {
+                        points = simplifyPolyline(points, g_collisionSimplifyTolerance, g_collisionSimplifyAngle);
+                        if (points.size() < 4) continue;
+                    }
+
+                    polylines.push_back({
+                        static_cast<std::uint32_t>(vertices.size()),
+                        static_cast<std::uint32_t>(points.size())});
+                    vertices.insert(vertices.end(), points.begin(), points.end());
+                }
+            }
+            else if (layer.getType() == tson::LayerType::ObjectGroup && layer.getName() == "Event colliders") {
+                for (auto& object : layer.getObjects()) {
+                    rmapEventCollider collider{};
+                    collider.x = static_cast<float>(object.getPosition().x);
+                    collider.y = static_cast<float>(object.getPosition().y);
+                    collider.width = static_cast<float>(object.getSize().x);
+                    collider.height = static_cast<float>(object.getSize().y);
+
+                    if (object.getName() == "MurderBox") {
+                        collider.type = static_cast<std::uint8_t>(sensorType::MURDER_BOX);
+                    }
+                    else if (object.getName() == "Checkpoint") {
+                        collider.type = static_cast<std::uint8_t>(sensorType::CHECKPOINT);
+                    }
+                    else if (object.getName() == "MapExit") {
+                        mapExit exit{};
+                        if (!readMapExit(object, mapDir, exit, error)) return false;
+
+                        rmapMapExit& outExit = mapExits.emplace_back();
+                        outExit.x = exit.rect.x;
+                        outExit.y = exit.rect.y;
+                        outExit.width = exit.rect.width;
+                        outExit.height = exit.rect.height;
+                        outExit.targetX = exit.targetPos.x;
+                        outExit.targetY = exit.targetPos.y;
+                        outExit.hasTargetPos = exit.hasTargetPos;
+                        mapExitTargets.push_back(fs::absolute(exit.targetMap).lexically_normal());
+
+                        collider.type = static_cast<std::uint8_t>(sensorType::MAP_EXIT);
+                    }
+                    else {
+                        error = "Incompatible event collider: " + object.getName();
+                        return false;
+                    }
+
+                    eventColliders.push_back(collider);
+                }
+            }
+            else if (layer.getType() == tson::LayerType::ObjectGroup && layer.getName() == "Lights") {
+                for (auto& object : layer.getObjects()) {
+                    lightSource light{};
+                    if (!readLight(object, light, error)) return false;
+
+                    lights.push_back({
+                        light.position.x,
+                        light.position.y,
+                        light.direction.x,
+                        light.direction.y,
+                        light.halfSize.x,
+                        light.halfSize.y,
+                        light.radius,
+                        light.intensity,
+                        light.coneAngle,
+                        light.softness,
+                        light.flicker,
+                        light.color.r,
+                        light.color.g,
+                        light.color.b,
+                        static_cast<std::uint8_t>(light.type)});
+                }
+            }
+            else {
+                error = "Incompatible layer type: " + layer.getName();
+                return false;
+            }
+        }
+
+        tson::PropertyCollection& props = map.getProperties();
+
+        for (const char* propName : {"playerStartX", "playerStartY", "bgNoisePath"}) {
+            if (!props.hasProperty(propName)) {
+                error = std::string("Map has no property \"") + propName + "\"";
+                return false;
+            }
+        }
+
+        // Pack everything that can share a texture into one image. It's kept small enough that the
+        // runtime atlas takes it as a single region, so it still shares a page with the sprite sheets.
+        std::vector<rmapImagePlacement> placements(images.size());
+        std::vector<bool> isPacked(images.size(), false);
+        fs::path atlasPath;
+
+        if (options.packAtlas) {
+            Image page = GenImageColor(g_atlasMaxImageSize, g_atlasMaxImageSize, BLANK);
+            atlasShelf shelf{};
+            int usedWidth = 0;
+
+            for (std::size_t i = 0; i < images.size(); i++) {
+                if (!images[i].isUsed || images[i].repeats) continue;
+
+                Image image = LoadImage((mapDir / images[i].path).string().c_str());
+
+                if (!IsImageValid(image)) {
+                    error = "Unable to load image: " + images[i].path;
+                    UnloadImage(page);
+                    return false;
+                }
+
+                ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+
+                // Images that don't fit keep their own texture
+                Vector2 position{};
+                if (packIntoShelf(shelf, g_atlasMaxImageSize, image.width, image.height, position)) {
+                    const int x = static_cast<int>(position.x);
+                    const int y = static_cast<int>(position.y);
+                    const auto* src = static_cast<const unsigned char*>(image.data);
+                    auto* dst = static_cast<unsigned char*>(page.data);
+
+                    for (int row = 0; row < image.height; row++) {
+                        std::memcpy(
+                            dst + (static_cast<std::size_t>(y + row) * page.width + x) * 4,
+                            src + static_cast<std::size_t>(row) * image.width * 4,
+                            static_cast<std::size_t>(image.width) * 4);
+                    }
+
+                    placements[i].rect = {
+                        position.x,
+                        position.y,
+                        static_cast<float>(image.width),
+                        static_cast<float>(image.height)};
+                    isPacked[i] = true;
+                    usedWidth = std::max(usedWidth, x + image.width);
+                }
+
+                UnloadImage(image);
+            }
+
+            if (usedWidth > 0) {
+                ImageCrop(&page, {0.0f, 0.0f, static_cast<float>(usedWidth),
+                    static_cast<float>(shelf.shelfY + shelf.shelfHeight)});
+
+                atlasPath = outputPath;
+                atlasPath.replace_extension(".atlas.png");
+
+                if (!ExportImage(page, atlasPath.string().c_str())) {
+                    error = "Unable to write atlas image: " + atlasPath.string();
+                    UnloadImage(page);
+                    return false;
+                }
+            }
+
+            UnloadImage(page);
+        }
+
+        // Texture paths are stored relative to the .rmap, which isn't necessarily next to the .tmj
+        const fs::path outputDir = fs::absolute(outputPath).parent_path();
+
+        if (!atlasPath.empty()) {
+            rmapTexture texture{};
+            texture.path = addString(atlasPath.filename().generic_string());
+            textures.push_back(texture);
+        }
+
+        for (std::size_t i = 0; i < images.size(); i++) {
+            if (!images[i].isUsed) continue;
+
+            if (isPacked[i]) {
+                placements[i].textureIndex = 0;
+                continue;
+            }
+
+            const fs::path imagePath = fs::absolute(mapDir / images[i].path).lexically_normal();
+
+            rmapTexture texture{};
+            texture.path = addString(imagePath.lexically_relative(outputDir).generic_string());
+            texture.repeats = images[i].repeats;
+
+            placements[i].textureIndex = static_cast<std::uint32_t>(textures.size());
+            textures.push_back(texture);
+        }
+
+        for (std::size_t i = 0; i < mapExits.size(); i++) {
+            mapExits[i].targetMap = addString(mapExitTargets[i].lexically_relative(outputDir).generic_string());
+        }
+
+        std::vector<fs::path> sourcePaths = getExternalTilesets(tiledMapPath);
+        sourcePaths.push_back(tiledMapPath);
+
+        for (const auto& image : images) {
+            sourcePaths.push_back(mapDir / image.path);
+        }
+
+        for (const auto& sourcePath : sourcePaths) {
+            std::error_code ec;
+            const fs::file_time_type modifiedTime = fs::last_write_time(sourcePath, ec);
+
+            if (ec) {
+                error = "Unable to read modification time of " + sourcePath.string() + ": " + ec.message();
+                return false;
+            }
+
+            const fs::path relativePath = fs::absolute(sourcePath).lexically_normal().lexically_relative(outputDir);
+            sources.push_back({addString(relativePath.generic_string()), modifiedTime.time_since_epoch().count()});
+        }
+
+        for (auto& [layer, tiles, image] : pendingLayers) {
+            if (layer.kind == static_cast<std::uint8_t>(mapLayerKind::IMAGE_LAYER)) {
+                const rmapImagePlacement& placement = placements[image];
+                layer.textureIndex = placement.textureIndex;
+                layer.srcX = placement.rect.x;
+                layer.srcY = placement.rect.y;
+                layer.srcWidth = placement.rect.width;
+                layer.srcHeight = placement.rect.height;
+                layers.push_back(layer);
+                continue;
+            }
+
+            layer.firstTile = static_cast<std::uint32_t>(tilePosX.size());
+            layer.tileCount = static_cast<std::uint32_t>(tiles.tiles.size());
+            layer.firstChunk = static_cast<std::uint32_t>(chunkStarts.size());
+            layer.chunksX = tiles.chunksX;
+            layer.chunksY = tiles.chunksY;
+            layer.gridOriginX = tiles.gridOrigin.x;
+            layer.gridOriginY = tiles.gridOrigin.y;
+            layer.chunkWidth = tiles.chunkSizePx.x;
+            layer.chunkHeight = tiles.chunkSizePx.y;
+            layer.maxTileWidth = tiles.maxTileSizePx.x;
+            layer.maxTileHeight = tiles.maxTileSizePx.y;
+            chunkStarts.insert(chunkStarts.end(), tiles.chunkStarts.begin(), tiles.chunkStarts.end());
+
+            for (const auto& tile : tiles.tiles) {
+                const rmapImagePlacement& placement = placements[tile.texture - tilesetPlaceholders.data()];
+
+                tilePosX.push_back(tile.position.x);
+                tilePosY.push_back(tile.position.y);
+                tileSrcX.push_back(tile.sourceRect.x + placement.rect.x);
+                tileSrcY.push_back(tile.sourceRect.y + placement.rect.y);
+                tileSrcWidth.push_back(tile.sourceRect.width);
+                tileSrcHeight.push_back(tile.sourceRect.height);
+                tileTexture.push_back(placement.textureIndex);
+            }
+
+            layers.push_back(layer);
+        }
+
+        header.magic = g_rmapMagic;
+        header.version = g_rmapVersion;
+        header.mapWidth = static_cast<std::uint16_t>(map.getSize().x);
+        header.mapHeight = static_cast<std::uint16_t>(map.getSize().y);
+        header.tileWidth = static_cast<std::uint8_t>(map.getTileSize().x);
+        header.tileHeight = static_cast<std::uint8_t>(map.getTileSize().y);
+        header.playerStartX = props.getValue<float>("playerStartX");
+        header.playerStartY = props.getValue<float>("playerStartY");
+        header.bgNoisePath = addString(props.getValue<std::string>("bgNoisePath"));
+
+        if (props.hasProperty("streamed") && props.getValue<bool>("streamed")) {
+            header.flags |= g_rmapStreamedFlag;
+        }
+
+        std::vector<std::byte> buffer(sizeof(rmapHeader));
+        header.strings = appendSection(buffer, strings);
+        header.textures = appendSection(buffer, textures);
+        header.layers = appendSection(buffer, layers);
+        header.tilePosX = appendSection(buffer, tilePosX);
+        header.tilePosY = appendSection(buffer, tilePosY);
+        header.tileSrcX = appendSection(buffer, tileSrcX);
+        header.tileSrcY = appendSection(buffer, tileSrcY);
+        header.tileSrcWidth = appendSection(buffer, tileSrcWidth);
+        header.tileSrcHeight = appendSection(buffer, tileSrcHeight);
+        header.tileTexture = appendSection(buffer, tileTexture);
+        header.polylines = appendSection(buffer, polylines);
+        header.vertices = appendSection(buffer, vertices);
+        header.eventColliders = appendSection(buffer, eventColliders);
+        header.chunkStarts = appendSection(buffer, chunkStarts);
+        header.mapExits = appendSection(buffer, mapExits);
+        header.lights = appendSection(buffer, lights);
+        header.sources = appendSection(buffer, sources);
+        std::memcpy(buffer.data(), &header, sizeof(rmapHeader));
+
+        std::ofstream f(outputPath, std::ios::binary | std::ios::trunc);
+
+        if (!f.is_open()) {
+            error = "Unable to open " + outputPath.string() + " for writing";
+            return false;
+        }
+
+        f.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+
+        if (!f.good()) {
+            error = "Unable to write " + outputPath.string();
+            return false;
+        }
+
+        return true;
+    }
+
+    bool compileBinaryMap(
+        const fs::path& tiledMapPath,
+        const fs::path& outputPath,
+        const rmapWriteOptions& options,
+        std::string& error)
+    {
+        fs::path binaryPath = outputPath;
+
+        if (binaryPath.empty()) {
+            binaryPath = tiledMapPath;
+            binaryPath.replace_extension(".rmap");
+        }
+
+        try {
+            tson::Tileson t;
+            const std::unique_ptr<tson::Map> map = t.parse(tiledMapPath);
+
+            if (map->getStatus() != tson::ParseStatus::OK) {
+                error = "Unable to parse map: " + map->getStatusMessage();
+                return false;
+            }
+
+            const std::vector<std::string> problems = validateTiledMap(*map, tiledMapPath.parent_path());
+
+            if (!problems.empty()) {
+                error.clear();
+
+                for (const auto& problem : problems) {
+                    error += (error.empty() ? "" : "\n") + problem;
+                }
+
+                return false;
+            }
+
+            return writeBinaryMap(*map, tiledMapPath, binaryPath, options, error);
+        }
+        catch (const std::exception& e) {
+            error = std::string("Unable to compile map: ") + e.what();
+            return false;
+        }
+    }
+
+    // Loading
+    // =================================================================================================================
+    // Views a section of the mapped file in place. Clears isValid if it doesn't fit inside the file.
+    template<typename T>
+    static std::span<const T> getSection(const MappedFile& file, const rmapSection& section, bool& isValid) {
+        const std::size_t fileSize = file.getSize();
+
+        if (section.offset % alignof(T) != 0 ||
+            section.offset > fileSize ||
+            section.count > (fileSize - section.offset) / sizeof(T))
+        {
+            isValid = false;
+            return {};
+        }
+
+        return {reinterpret_cast<const T*>(file.getData() + section.offset), static_cast<std::size_t>(section.count)};
+    }
+
+    [[nodiscard]] std::string_view getRmapString(std::span<const char> strings, const rmapString& str, bool& isValid) {
+        if (str.offset > strings.size() || str.length > strings.size() - str.offset) {
+            isValid = false;
+            return {};
+        }
+
+        return {strings.data() + str.offset, str.length};
+    }
+
+    bool viewBinaryMap(const MappedFile& file, const fs::path& mapPath, rmapView& view, std::string& error) {
+        if (!file.isValid() || file.getSize() < sizeof(rmapHeader)) {
+            error = "Unable to map binary map file: " + mapPath.string();
+            return false;
+        }
+
+        rmapHeader& header = view.header;
+        std::memcpy(&header, file.getData(), sizeof(rmapHeader));
+
+        if (header.magic != g_rmapMagic || header.version != g_rmapVersion) {
+            error = "Not an .rmap file, or compiled for a different version: " + mapPath.string();
+            return false;
+        }
+
+        bool isValid = true;
+        view.strings = getSection<char>(file, header.strings, isValid);
+        view.textures = getSection<rmapTexture>(file, header.textures, isValid);
+        view.layers = getSection<rmapLayer>(file, header.layers, isValid);
+        view.tilePosX = getSection<float>(file, header.tilePosX, isValid);
+        view.tilePosY = getSection<float>(file, header.tilePosY, isValid);
+        view.tileSrcX = getSection<float>(file, header.tileSrcX, isValid);
+        view.tileSrcY = getSection<float>(file, header.tileSrcY, isValid);
+        view.tileSrcWidth = getSection<float>(file, header.tileSrcWidth, isValid);
+        view.tileSrcHeight = getSection<float>(file, header.tileSrcHeight, isValid);
+        view.tileTexture = getSection<std::uint32_t>(file, header.tileTexture, isValid);
+        view.polylines = getSection<rmapPolyline>(file, header.polylines, isValid);
+        view.vertices = getSection<b2Vec2>(file, header.vertices, isValid);
+        view.eventColliders = getSection<rmapEventCollider>(file, header.eventColliders, isValid);
+        view.chunkStarts = getSection<std::uint32_t>(file, header.chunkStarts, isValid);
+        view.mapExits = getSection<rmapMapExit>(file, header.mapExits, isValid);
+        view.lights = getSection<rmapLight>(file, header.lights, isValid);
+        view.sources = getSection<rmapSource>(file, header.sources, isValid);
+
+        // Every tile array has to be the same length
+        const std::size_t tileCount = view.tilePosX.size();
+        isValid &= view.tilePosY.size() == tileCount && view.tileSrcX.size() == tileCount &&
+            view.tileSrcY.size() == tileCount && view.tileSrcWidth.size() == tileCount &&
+            view.tileSrcHeight.size() == tileCount && view.tileTexture.size() == tileCount;
+
+        // Chunk and region sizes are multiples of these, so none of them can be zero
+        isValid &= header.tileWidth != 0 && header.tileHeight != 0 && header.mapWidth != 0 && header.mapHeight != 0;
+
+        if (!isValid) {
+            error = "Binary map is truncated or corrupt: " + mapPath.string();
+            return false;
+        }
+
+        return true;
+    }
+
+    [[nodiscard]] bool isBinaryMapCurrent(const fs::path& binaryPath) {
+        const MappedFile file(binaryPath);
+        rmapView view{};
+        std::string error;
+
+        if (!viewBinaryMap(file, binaryPath, view, error)) return false;
+
+        const fs::path binaryDir = binaryPath.parent_path();
+
+        for (const auto& source : view.sources) {
+            bool isValid = true;
+            const std::string_view path = getRmapString(view.strings, source.path, isValid);
+            if (!isValid) return false;
+
+            std::error_code ec;
+            const fs::file_time_type modifiedTime = fs::last_write_time(binaryDir / path, ec);
+
+            if (ec || modifiedTime.time_since_epoch().count() != source.modifiedTime) return false;
+        }
+
+        return !view.sources.empty();
+    }
+
+    [[nodiscard]] bool isValidTileLayer(const rmapView& view, const rmapLayer& layer) {
+        const std::size_t tileCount = view.tilePosX.size();
+        const std::size_t chunkCount = static_cast<std::size_t>(layer.chunksX) * layer.chunksY;
+
+        if (layer.firstTile > tileCount || layer.tileCount > tileCount - layer.firstTile ||
+            layer.firstChunk > view.chunkStarts.size() || chunkCount + 1 > view.chunkStarts.size() - layer.firstChunk)
+        {
+            return false;
+        }
+
+        const auto layerChunkStarts = view.chunkStarts.subspan(layer.firstChunk, chunkCount + 1);
+        if (layerChunkStarts.front() != 0 || layerChunkStarts.back() != layer.tileCount ||
+            !std::ranges::is_sorted(layerChunkStarts))
+        {
+            return false;
+        }
+
+        for (std::size_t i = layer.firstTile; i < layer.firstTile + layer.tileCount; i++) {
+            if (view.tileTexture[i] >= view.textures.size()) return false;
+        }
+
+        return true;
+    }
+
+    bool stageBinaryMap(const fs::path& mapPath, StagedMap& staged) {
+        MapData& mapData = staged.mapData;
+        const MappedFile file(mapPath);
+        rmapView view{};
+
+        if (!viewBinaryMap(file, mapPath, view, staged.error)) return false;
+
+        const rmapHeader& header = view.header;
+        bool isValid = true;
+
+        mapData.baseDir = fs::relative(mapPath);
+        mapData.fullMapPath = fs::relative(mapPath);
+        if (mapData.baseDir.has_extension()) {
+            mapData.baseDir.remove_filename();
+        }
+
+        mapData.mapWidth = header.mapWidth;
+        mapData.mapHeight = header.mapHeight;
+        mapData.tileWidth = header.tileWidth;
+        mapData.tileHeight = header.tileHeight;
+        mapData.isStreamed = header.flags & g_rmapStreamedFlag;
+
+        // Image decoding is the only real work left, everything else is copied straight out of the file.
+        // A path listed twice is only staged once, so the file's texture indices are looked up through this.
+        std::vector<std::uint32_t> textureIndices;
+        textureIndices.reserve(view.textures.size());
+        const std::size_t stepCount = view.textures.size() + view.layers.size();
+
+        for (const auto& texture : view.textures) {
+            const std::string_view path = getRmapString(view.strings, texture.path, isValid);
+            const std::uint32_t index =
+                stageMapTexture(mapData.baseDir.string() + std::string(path), texture.repeats, staged);
+
+            if (index == g_noStagedTexture) return false;
+
+            textureIndices.push_back(index);
+            setStagingProgress(staged, textureIndices.size(), stepCount);
+        }
+
+        const Vector2 chunkSizePx = getTileChunkSize(mapData);
+
+        for (const auto& layer : view.layers) {
+            setStagingProgress(staged, textureIndices.size() + staged.layers.size(), stepCount);
+
+            stagedLayer outLayer{};
+            outLayer.passMask = layer.passMask;
+            outLayer.textureIndex = g_noStagedTexture;
+
+            renderPassEntry& entry = outLayer.entry;
+            entry.kind = static_cast<mapLayerKind>(layer.kind);
+            entry.parallax = {layer.parallaxX, layer.parallaxY};
+            entry.offset = {layer.offsetX, layer.offsetY};
+            entry.tint = {layer.tint[0], layer.tint[1], layer.tint[2], layer.tint[3]};
+            entry.repeatX = layer.repeatX;
+            entry.repeatY = layer.repeatY;
+
+            if (entry.kind == mapLayerKind::TILE_LAYER) {
+                if (!isValidTileLayer(view, layer)) {
+                    isValid = false;
+                    break;
+                }
+
+                TileLayerData& layerData = staged.tileLayers.emplace_back();
+                entry.tileLayerIndex = staged.tileLayers.size() - 1;
+
+                // The streamer fills these in a region at a time, the layer only holds its place in the draw order
+                if (mapData.isStreamed && isStreamedLayer(entry)) {
+                    bucketTileLayer({}, chunkSizePx, layerData);
+                    staged.layers.push_back(outLayer);
+                    continue;
+                }
+
+                layerData.tiles.reserve(layer.tileCount);
+
+                for (std::size_t i = layer.firstTile; i < layer.firstTile + layer.tileCount; i++) {
+                    layerData.tiles.push_back({
+                        {view.tileSrcX[i], view.tileSrcY[i], view.tileSrcWidth[i], view.tileSrcHeight[i]},
+                        {view.tilePosX[i], view.tilePosY[i]},
+                        &staged.placeholders[textureIndices[view.tileTexture[i]]]});
+                }
+
+                if (layer.chunkWidth == chunkSizePx.x && layer.chunkHeight == chunkSizePx.y) {
+                    // Tiles were sorted into chunks by the compiler, so they can be taken as they are
+                    const auto layerChunkStarts = view.chunkStarts.subspan(
+                        layer.firstChunk,
+                        static_cast<std::size_t>(layer.chunksX) * layer.chunksY + 1);
+
+                    layerData.chunkStarts.assign(layerChunkStarts.begin(), layerChunkStarts.end());
+                    layerData.gridOrigin = {layer.gridOriginX, layer.gridOriginY};
+                    layerData.chunkSizePx = chunkSizePx;
+                    layerData.maxTileSizePx = {layer.maxTileWidth, layer.maxTileHeight};
+                    layerData.chunksX = layer.chunksX;
+                    layerData.chunksY = layer.chunksY;
+                }
+                else {
+                    // Compiled with a different g_tileChunkSize, redo the chunking
+                    const std::vector<TileData> unsortedTiles = std::move(layerData.tiles);
+                    bucketTileLayer(unsortedTiles, chunkSizePx, layerData);
+                }
+            }
+            else if (entry.kind == mapLayerKind::IMAGE_LAYER && layer.textureIndex < textureIndices.size()) {
+                // Image layers packed into the map's atlas image only use part of it
+                outLayer.textureIndex = textureIndices[layer.textureIndex];
+                entry.sourceRect = {layer.srcX, layer.srcY, layer.srcWidth, layer.srcHeight};
+            }
+            else {
+                isValid = false;
+                break;
+            }
+
+            staged.layers.push_back(outLayer);
+        }
+
+        // Streamed maps create their collision and sensors as regions come into range
+        if (!mapData.isStreamed) {
+            staged.polylines.reserve(view.polylines.size());
+
+            for (const auto& polyline : view.polylines) {
+                if (polyline.firstVertex > view.vertices.size() ||
+                    polyline.vertexCount > view.vertices.size() - polyline.firstVertex)
+                {
+                    isValid = false;
+                    break;
+                }
+
+                const auto first = view.vertices.begin() + polyline.firstVertex;
+                staged.polylines.emplace_back(first, first + polyline.vertexCount);
+            }
+
+            staged.eventColliders.reserve(view.eventColliders.size());
+
+            for (const auto& collider : view.eventColliders) {
+                if (collider.type >= static_cast<std::uint8_t>(sensorType::COUNT)) {
+                    isValid = false;
+                    break;
+                }
+
+                staged.eventColliders.push_back({
+                    {collider.x, collider.y, collider.width, collider.height},
+                    static_cast<sensorType>(collider.type)});
+            }
+        }
+
+        // Exits are needed up front for prefetching even when their sensors are streamed
+        mapData.mapExits.reserve(view.mapExits.size());
+
+        for (const auto& exit : view.mapExits) {
+            mapData.mapExits.push_back({
+                {exit.x, exit.y, exit.width, exit.height},
+                (mapData.baseDir / getRmapString(view.strings, exit.targetMap, isValid)).lexically_normal(),
+                {exit.targetX, exit.targetY},
+                exit.hasTargetPos != 0});
+        }
+
+        // Lights are few and cheap, streamed maps keep all of them too
+        mapData.lights.reserve(view.lights.size());
+
+        for (const auto& light : view.lights) {
+            if (light.type >= static_cast<std::uint8_t>(lightType::COUNT)) {
+                isValid = false;
+                break;
+            }
+
+            mapData.lights.push_back({
+                {light.x, light.y},
+                {light.directionX, light.directionY},
+                {light.halfWidth, light.halfHeight},
+                {light.r, light.g, light.b, 255},
+                light.radius,
+                light.intensity,
+                light.coneAngle,
+                light.softness,
+                light.flicker,
+                static_cast<lightType>(light.type)});
+        }
+
+        mapData.playerStartPos = {header.playerStartX, header.playerStartY};
+        mapData.bgNoisePath = fs::path(getRmapString(view.strings, header.bgNoisePath, isValid));
+
+        if (!isValid) {
+            staged.error = "Binary map contains out of range indices: " + mapPath.string();
+            return false;
+        }
+
+        return true;
+    }
+
+    MapData loadBinaryMap(const fs::path& mapPath, const b2WorldId world, const std::shared_ptr<TextureAtlas>& atlas) {
+        StagedMap staged;
+
+        if (!stageBinaryMap(mapPath, staged)) {
+            logFatal(staged.error + ". loadBinaryMap(Args...)");
+            unloadStagedMap(staged);
+            return {};
+        }
+
+        MapData mapData = finishStagedMap(staged, world, atlas);
+
+        #ifdef DEBUG
+            logDbg("Binary map loaded successfully.");
+        #endif
+
+        return mapData;
+    }
+
+    // Benchmarking
+    // =================================================================================================================
+    void benchmarkMapLoad(const fs::path& tiledMapPath, const int iterations) {
+        fs::path binaryPath = tiledMapPath;
+        binaryPath.replace_extension(".rmap");
+
+        std::string error;
+        if (!compileBinaryMap(tiledMapPath, binaryPath, {true, true}, error)) {
+            logFatal("Unable to compile " + tiledMapPath.string() + ": " + error + ". benchmarkMapLoad(Args...)");
+            return;
+        }
+
+        // Each load gets a fresh world and atlas so both paths pay for the same physics and texture setup
+        const auto timeLoads = [iterations](const auto& loadFunc) {
+            CodeClock clock;
+
+            for (int i = 0; i < iterations; i++) {
+                const b2WorldDef worldDef = b2DefaultWorldDef();
+                const b2WorldId world = b2CreateWorld(&worldDef);
+
+                {
+                    const auto atlas = std::make_shared<TextureAtlas>();
+
+                    clock.begin();
+                    const MapData map = loadFunc(world, atlas);
+                    clock.end();
+
+                    if (map.renderDataPtr) unloadMap(map);
+                }
+
+                b2DestroyWorld(world);
+            }
+        };
+
+        logDbg("Benchmarking .tmj load over ", iterations, " iterations: ", tiledMapPath.string());
+        timeLoads([&tiledMapPath](const b2WorldId world, const std::shared_ptr<TextureAtlas>& atlas) {
+            return loadTiledMap(tiledMapPath.string(), world, atlas);
+        });
+
+        logDbg("Benchmarking .rmap load over ", iterations, " iterations: ", binaryPath.string());
+        timeLoads([&binaryPath](const b2WorldId world, const std::shared_ptr<TextureAtlas>& atlas) {
+            return loadBinaryMap(binaryPath, world, atlas);
+        });
+    }
+}
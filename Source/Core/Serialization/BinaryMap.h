@@ -0,0 +1,257 @@
+//
+// Author: DirgeWuff
+// Created on: 10/18/26
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Module purpose/description:
+//
+// Layout of the precompiled binary map format (.rmap), and functions to write
+// one from a Tiled map. Tiled's .tmj stays the authoring format, .rmap files
+// are memory mapped at load time and read in place, nothing is parsed.
+//
+// A file is an rmapHeader followed by a number of sections. Each section is a
+// flat array of one of the POD types below, aligned to 8 bytes, and located by
+// the offset/count pair in the header. Tiles are stored as one array per field.
+// Positions and source rects are in pixels and relative to the tileset image,
+// collision vertices are already in meters.
+//
+// Tile layers are stored pre-chunked: tiles are already sorted into the same
+// chunk grid the renderer uses, so loading one is a copy. Maps built by
+// redeye-mapc may also reference a packed atlas image written next to the
+// .rmap instead of the original tilesets, and have simplified collision.
+//
+// Maps with the "streamed" property are never loaded whole, WorldStreamer
+// reads their tiles, collision and sensors out of the mapped file a region at
+// a time.
+//
+// Every file a map was compiled from, the .tmj, external tilesets and images,
+// is listed with its modification time, so a stale .rmap is recompiled even
+// when only a tileset changed.
+
+#ifndef BINARYMAP_H
+#define BINARYMAP_H
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "box2d/types.h"
+#include "../external_libs/Tson/tileson.hpp"
+#include "../Utility/MappedFile.h"
+
+namespace fs = std::filesystem;
+
+namespace RE::Core {
+    constexpr std::uint32_t g_rmapMagic = 0x50414D52; // "RMAP"
+    constexpr std::uint32_t g_rmapVersion = 6;
+
+    constexpr std::uint8_t g_rmapStreamedFlag = 1 << 0; // Set in rmapHeader::flags
+
+    struct rmapSection {
+        std::uint64_t offset; // From the start of the file
+        std::uint64_t count;  // Number of elements, not bytes
+    };
+
+    // Slice of the string data section
+    struct rmapString {
+        std::uint32_t offset;
+        std::uint32_t length;
+    };
+
+    struct rmapTexture {
+        rmapString path;       // Relative to the map's directory, same as in Tiled
+        std::uint8_t repeats;  // Used by a repeating image layer, needs its own wrapping texture
+        std::uint8_t padding[7];
+    };
+
+    struct rmapLayer {
+        std::uint8_t kind;     // mapLayerKind
+        std::uint8_t passMask; // g_primaryPassBit | g_differedPassBit
+        std::uint8_t repeatX;
+        std::uint8_t repeatY;
+        std::uint8_t tint[4];
+        std::uint32_t textureIndex; // Image layers only
+        std::uint32_t firstTile;    // Tile layers only, tiles are in chunk order
+        std::uint32_t tileCount;
+        std::uint32_t firstChunk;   // Into chunkStarts, chunksX * chunksY + 1 entries relative to firstTile
+        std::uint16_t chunksX;      // 0 if the layer is empty
+        std::uint16_t chunksY;
+        float parallaxX;
+        float parallaxY;
+        float offsetX;
+        float offsetY;
+        float gridOriginX;          // Chunk grid, same meaning as in TileLayerData
+        float gridOriginY;
+        float chunkWidth;
+        float chunkHeight;
+        float maxTileWidth;
+        float maxTileHeight;
+        float srcX;                 // Part of the texture holding an image layer, srcWidth 0 for all of it
+        float srcY;
+        float srcWidth;
+        float srcHeight;
+    };
+
+    struct rmapPolyline {
+        std::uint32_t firstVertex;
+        std::uint32_t vertexCount;
+    };
+
+    struct rmapEventCollider {
+        float x;
+        float y;
+        float width;
+        float height;
+        std::uint8_t type; // sensorType
+        std::uint8_t padding[3];
+    };
+
+    // The sensor itself is in eventColliders as a sensorType::MAP_EXIT, this says where it leads
+    struct rmapMapExit {
+        float x;
+        float y;
+        float width;
+        float height;
+        rmapString targetMap;       // Relative to the .rmap's directory
+        float targetX;              // Player center in the target map, pixels
+        float targetY;
+        std::uint8_t hasTargetPos;  // Otherwise the target map's player start is used
+        std::uint8_t padding[3];
+    };
+
+    // lightSource, with the color packed down to bytes
+    struct rmapLight {
+        float x;
+        float y;
+        float directionX;
+        float directionY;
+        float halfWidth;
+        float halfHeight;
+        float radius;
+        float intensity;
+        float coneAngle;
+        float softness;
+        float flicker;
+        std::uint8_t r;
+        std::uint8_t g;
+        std::uint8_t b;
+        std::uint8_t type;  // lightType
+    };
+
+    // A file the map was compiled from
+    struct rmapSource {
+        rmapString path;            // Relative to the .rmap's directory
+        std::int64_t modifiedTime;  // fs::last_write_time() at compile time, in file clock ticks
+    };
+
+    struct rmapHeader {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint16_t mapWidth;
+        std::uint16_t mapHeight;
+        std::uint8_t tileWidth;
+        std::uint8_t tileHeight;
+        std::uint8_t flags;
+        std::uint8_t padding;
+        float playerStartX;
+        float playerStartY;
+        rmapString bgNoisePath;
+        rmapSection strings;        // char
+        rmapSection textures;       // rmapTexture
+        rmapSection layers;         // rmapLayer
+        rmapSection tilePosX;       // float
+        rmapSection tilePosY;       // float
+        rmapSection tileSrcX;       // float
+        rmapSection tileSrcY;       // float
+        rmapSection tileSrcWidth;   // float, negative when flipped
+        rmapSection tileSrcHeight;  // float, negative when flipped
+        rmapSection tileTexture;    // uint32_t, index into textures
+        rmapSection polylines;      // rmapPolyline
+        rmapSection vertices;       // b2Vec2
+        rmapSection eventColliders; // rmapEventCollider
+        rmapSection chunkStarts;    // uint32_t, see rmapLayer
+        rmapSection mapExits;       // rmapMapExit
+        rmapSection lights;         // rmapLight
+        rmapSection sources;        // rmapSource
+    };
+
+    static_assert(sizeof(rmapTexture) == 16);
+    static_assert(sizeof(rmapLayer) == 84);
+    static_assert(sizeof(rmapEventCollider) == 20);
+    static_assert(sizeof(rmapMapExit) == 36);
+    static_assert(sizeof(rmapLight) == 48);
+    static_assert(sizeof(rmapSource) == 16);
+    static_assert(sizeof(b2Vec2) == 8);
+
+    // Every section of a mapped .rmap, viewed in place. Only valid for as long as the file stays mapped.
+    struct rmapView {
+        rmapHeader header;
+        std::span<const char> strings;
+        std::span<const rmapTexture> textures;
+        std::span<const rmapLayer> layers;
+        std::span<const float> tilePosX;
+        std::span<const float> tilePosY;
+        std::span<const float> tileSrcX;
+        std::span<const float> tileSrcY;
+        std::span<const float> tileSrcWidth;
+        std::span<const float> tileSrcHeight;
+        std::span<const std::uint32_t> tileTexture;
+        std::span<const rmapPolyline> polylines;
+        std::span<const b2Vec2> vertices;
+        std::span<const rmapEventCollider> eventColliders;
+        std::span<const std::uint32_t> chunkStarts;
+        std::span<const rmapMapExit> mapExits;
+        std::span<const rmapLight> lights;
+        std::span<const rmapSource> sources;
+    };
+
+    struct rmapWriteOptions {
+        bool simplifyCollision; // Run collision through simplifyPolyline(), see CollisionSpline.h
+        bool packAtlas;         // Pack tilesets and image layers into <map>.atlas.png next to the output
+    };
+
+    // Checks that a map only uses what the loader understands: tile, image and object layers,
+    // the map properties, collider names, and image files that exist. Returns every problem found.
+    [[nodiscard]] std::vector<std::string> validateTiledMap(tson::Map& map, const fs::path& mapDir);
+
+    // Compiles an already parsed Tiled map, read from tiledMapPath, to an .rmap file. Returns false and sets
+    // error on failure. Never logs fatally, so it's safe to call from the headless compiler and from worker threads.
+    bool writeBinaryMap(
+        tson::Map& map,
+        const fs::path& tiledMapPath,
+        const fs::path& outputPath,
+        const rmapWriteOptions& options,
+        std::string& error);
+
+    // Parses and validates a .tmj, then writes the .rmap next to it, or to outputPath if one is given
+    bool compileBinaryMap(
+        const fs::path& tiledMapPath,
+        const fs::path& outputPath,
+        const rmapWriteOptions& options,
+        std::string& error);
+
+    // Checks the header and that every section fits inside the file, without looking at the contents.
+    // Returns false and sets error if the file isn't a readable .rmap.
+    bool viewBinaryMap(const MappedFile& file, const fs::path& mapPath, rmapView& view, std::string& error);
+
+    // True if binaryPath is a readable .rmap and every file it was compiled from still has the same
+    // modification time. Sources that can no longer be found count as changed.
+    [[nodiscard]] bool isBinaryMapCurrent(const fs::path& binaryPath);
+
+    // Views a string in the string section. Clears isValid if it doesn't fit inside the section.
+    [[nodiscard]] std::string_view getRmapString(std::span<const char> strings, const rmapString& str, bool& isValid);
+
+    // Checks a tile layer's tile and chunk ranges against the rest of the file
+    [[nodiscard]] bool isValidTileLayer(const rmapView& view, const rmapLayer& layer);
+
+    // Recompiles the map, then logs the average load time of the .tmj and the .rmap
+    void benchmarkMapLoad(const fs::path& tiledMapPath, int iterations);
+}
+
+#endif //BINARYMAP_H
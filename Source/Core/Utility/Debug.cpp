@@ -17,8 +17,10 @@
 #define RAYGUI_IMPLEMENTATION
 
 #include <cassert>
+#include <cstdlib>
 #include <iostream>
 #include <cstdint>
+#include <new>
 #include "box2d/box2d.h"
 #include "raylib.h"
 #include "Tson/tileson.hpp"
@@ -26,10 +28,58 @@
 #include "Debug.h"
 #include "Utils.h"
 #include "../Entity/Player.h"
+#include "../Renderer/TilemapRenderer.h"
+#include "../Renderer/WorldStreamer.h"
+#include "../Renderer/LightManager.h"
+#include "../Renderer/DynamicResolution.h"
+#include "../Renderer/RenderQueue.h"
+#include "../Backend/TaskScheduler.h"
 #include "../../Application/Layers/GameLayer.h"
 #include "../Utility/Globals.h"
 
+#ifdef DEBUG
+    // Per thread, so the main thread's count isn't thrown off by workers loading maps in the meantime
+    static thread_local std::size_t s_heapAllocCount = 0;
+
+    // Replaces the global allocator so renderer hot paths can be checked for allocations.
+    // The other new/delete overloads forward to these by default.
+    void* operator new(const std::size_t size) {
+        s_heapAllocCount++;
+
+        if (void* ptr = std::malloc(size == 0 ? 1 : size)) return ptr;
+        throw std::bad_alloc();
+    }
+
+    void* operator new[](const std::size_t size) {
+        return ::operator new(size);
+    }
+
+    void operator delete(void* ptr) noexcept {
+        std::free(ptr);
+    }
+
+    void operator delete[](void* ptr) noexcept {
+        std::free(ptr);
+    }
+
+    void operator delete(void* ptr, std::size_t) noexcept {
+        std::free(ptr);
+    }
+
+    void operator delete[](void* ptr, std::size_t) noexcept {
+        std::free(ptr);
+    }
+#endif
+
 namespace RE::Core {
+    [[nodiscard]] std::size_t getHeapAllocCount() noexcept {
+        #ifdef DEBUG
+            return s_heapAllocCount;
+        #else
+            return 0;
+        #endif
+    }
+
     // TODO: Create functions to disable camera lock and move camera on demand
     void drawDebugBodyShapes(const Player& player) {
         if (!g_drawPlayerShapes) return;
@@ -210,14 +260,10 @@ namespace RE::Core {
         }
     }
 
-    void drawDebugCollisionShapes(const MapData& map) {
-        if (!g_drawTerrainShapes) return;
-
-        const std::vector<CollisionSpline>& shapes = map.collisionObjects;
-
-        for (const auto& shape : shapes) {
-            const b2Vec2* points = shape.getObjectVerts();
-            const std::size_t numVerts = shape.getVertCount();
+    static void drawCollisionShapes(const CollisionStore& shapes) {
+        for (const auto& shape : shapes.getSplines()) {
+            const std::span<const b2Vec2> points = shapes.getVerts(shape);
+            const std::size_t numVerts = points.size();
 
             std::vector<Vector2> tfedVerts;
 
@@ -235,17 +281,17 @@ namespace RE::Core {
         }
     }
 
-    // TODO: Improve speed on this, will tank framerate when used
-    void drawDebugCollisionVerts(const MapData& map) {
-        if (!g_drawTerrainVerts) return;
-
-        const std::vector<CollisionSpline>& shapes = map.collisionObjects;
+    void drawDebugCollisionShapes(const MapData& map) {
+        if (!g_drawTerrainShapes) return;
 
-        for (const auto& shape : shapes) {
-            const b2Vec2* points = shape.getObjectVerts();
+        drawCollisionShapes(map.collisionObjects);
+    }
 
-            for (std::size_t i = 0; i < shape.getVertCount(); i++) {
-                const Vector2 translatedPoint = metersToPixelsVec(points[i]);
+    // TODO: Improve speed on this, will tank framerate when used
+    static void drawCollisionVerts(const CollisionStore& shapes) {
+        for (const auto& shape : shapes.getSplines()) {
+            for (const b2Vec2& point : shapes.getVerts(shape)) {
+                const Vector2 translatedPoint = metersToPixelsVec(point);
 
                 DrawCircleV(
                     translatedPoint,
@@ -255,11 +301,13 @@ namespace RE::Core {
         }
     }
 
-    void drawDebugEventColliders(const MapData& map) {
-        if (!g_drawEventColliders) return;
+    void drawDebugCollisionVerts(const MapData& map) {
+        if (!g_drawTerrainVerts) return;
 
-        const std::vector<EventCollider>& colliders = map.eventColliders;
+        drawCollisionVerts(map.collisionObjects);
+    }
 
+    static void drawEventColliders(const std::vector<EventCollider>& colliders) {
         for (const auto& collider : colliders) {
             const Vector2 pos = collider.getPosPixels();
             const Vector2 size = collider.getSizePx();
@@ -290,6 +338,38 @@ namespace RE::Core {
         }
     }
 
+    void drawDebugEventColliders(const MapData& map) {
+        if (!g_drawEventColliders) return;
+
+        drawEventColliders(map.eventColliders);
+    }
+
+    void drawDebugStreamedRegions(const WorldStreamer& streamer) {
+        if (!g_drawStreamedRegions) return;
+
+        for (const auto& [key, region] : streamer.getRegions()) {
+            const Rectangle bounds = streamer.getRegionBounds(key);
+            const Color color = region.state == regionState::LOADED ? g_debugColliderColor : YELLOW;
+
+            DrawRectangleLinesEx(bounds, 2.0f, color);
+            DrawText(
+                TextFormat(
+                    "%s | Chains: %zu Sensors: %zu",
+                    regionStateToStr(region.state).c_str(),
+                    region.collisionObjects.size(),
+                    region.eventColliders.size()),
+                static_cast<int>(bounds.x + 8.0f),
+                static_cast<int>(bounds.y + 8.0f),
+                g_debugTextSize,
+                color);
+
+            // Streamed collision lives in the regions rather than the map
+            if (g_drawTerrainShapes) drawCollisionShapes(region.collisionObjects);
+            if (g_drawTerrainVerts) drawCollisionVerts(region.collisionObjects);
+            if (g_drawEventColliders) drawEventColliders(region.eventColliders);
+        }
+    }
+
     void drawDebugPlayerAnimId(const animationId& id) {
         if (!g_drawPlayerAnimId) return;
 
@@ -322,26 +402,132 @@ namespace RE::Core {
             RED);
     }
 
+    void drawDebugTileRenderStats(const renderQueueStats& queueStats) {
+        if (!g_drawTileRenderStats) return;
+
+        Vector2 adjustedPos = g_debugTextPos;
+        adjustedPos.y += g_totalDebugTextHeight *
+            (g_drawPlayerPos + g_drawPlayerSensorStatus + g_drawPlayerAnimId + g_drawPlayerActionState);
+
+        const tileRenderStats& stats = getTileRenderStats();
+
+        DrawText(TextFormat(
+                "Tiles drawn: %zu visited: %zu culled: %zu total: %zu | Baked chunks: %zu (%.1f MB) | "
+                "Image copies: %zu | Allocs: %zu\n"
+                "Queued draws: %zu | Draw calls: %zu | Texture changes: %zu | Shader changes: %zu",
+                stats.drawnTiles,
+                stats.visitedTiles,
+                stats.culledTiles,
+                stats.totalTiles,
+                stats.drawnChunks,
+                static_cast<float>(stats.bakedChunkBytes) / (1024.0f * 1024.0f),
+                stats.drawnImageCopies,
+                stats.heapAllocations,
+                queueStats.commands,
+                queueStats.drawCalls,
+                queueStats.textureChanges,
+                queueStats.shaderChanges),
+            static_cast<int>(adjustedPos.x),
+            static_cast<int>(adjustedPos.y),
+            g_debugTextSize,
+            RED);
+    }
+
+    void drawDebugLightStats(const LightManager& lights) {
+        if (!g_drawLightStats) return;
+
+        // Tile render stats take two rows
+        Vector2 adjustedPos = g_debugTextPos;
+        adjustedPos.y += g_totalDebugTextHeight *
+            (g_drawPlayerPos + g_drawPlayerSensorStatus + g_drawPlayerAnimId + g_drawPlayerActionState +
+            2 * g_drawTileRenderStats);
+
+        const lightStats& stats = lights.getStats();
+
+        DrawText(TextFormat(
+                "Lights visible: %zu total: %zu | Most in one tile: %zu | Tiles over the cap: %zu\n"
+                "Shadows redrawn: %zu cached: %zu",
+                stats.visibleLights,
+                stats.totalLights,
+                stats.maxLightsInTile,
+                stats.overflowingTiles,
+                stats.shadowsRecomputed,
+                stats.shadowCacheHits),
+            static_cast<int>(adjustedPos.x),
+            static_cast<int>(adjustedPos.y),
+            g_debugTextSize,
+            RED);
+    }
+
+    void drawDebugRenderScale(const DynamicResolution& resolution) {
+        if (!g_drawRenderScale) return;
+
+        // Tile render and light stats take two rows each
+        Vector2 adjustedPos = g_debugTextPos;
+        adjustedPos.y += g_totalDebugTextHeight *
+            (g_drawPlayerPos + g_drawPlayerSensorStatus + g_drawPlayerAnimId + g_drawPlayerActionState +
+            2 * g_drawTileRenderStats + 2 * g_drawLightStats);
+
+        DrawText(TextFormat(
+                "Render scale: %.0f%% | Headroom: %.0f%% | CPU: %.2f ms present: %.2f ms",
+                resolution.getScale() * 100.0f,
+                resolution.getHeadroom() * 100.0,
+                resolution.getAverageCpuSeconds() * 1000.0,
+                resolution.getAveragePresentSeconds() * 1000.0),
+            static_cast<int>(adjustedPos.x),
+            static_cast<int>(adjustedPos.y),
+            g_debugTextSize,
+            RED);
+    }
+
+    void drawDebugSchedulerStats(const schedulerStats& stats) {
+        if (!g_drawSchedulerStats) return;
+
+        // Tile render and light stats take two rows each
+        Vector2 adjustedPos = g_debugTextPos;
+        adjustedPos.y += g_totalDebugTextHeight *
+            (g_drawPlayerPos + g_drawPlayerSensorStatus + g_drawPlayerAnimId + g_drawPlayerActionState +
+            2 * g_drawTileRenderStats + 2 * g_drawLightStats + g_drawRenderScale);
+
+        DrawText(TextFormat(
+                "Task workers: %zu busy: %.0f%% | Queued: %zu main thread: %zu | Run last frame: %zu",
+                stats.workerCount,
+                stats.utilization * 100.0f,
+                stats.queuedTasks,
+                stats.queuedMainThreadTasks,
+                stats.tasksRun),
+            static_cast<int>(adjustedPos.x),
+            static_cast<int>(adjustedPos.y),
+            g_debugTextSize,
+            RED);
+    }
+
     void drawControlsWindow() {
             g_debugWindowBoxActive = IsKeyDown(KEY_M);
 
         if (g_debugWindowBoxActive) {
 
-            g_debugWindowBoxActive = !GuiWindowBox(Rectangle{ 8, 432, 240, 320 }, "Debug drawing controls");
+            g_debugWindowBoxActive = !GuiWindowBox(Rectangle{ 8, 312, 240, 488 }, "Debug drawing controls");
 
             // Each button adds 24px in height for future reference
-            GuiCheckBox(Rectangle{ 16, 464, 12, 12 }, "Draw player shapes", &g_drawPlayerShapes);
-            GuiCheckBox(Rectangle{ 16, 488, 12, 12 }, "Draw player sensor status", &g_drawPlayerSensorStatus);
-            GuiCheckBox(Rectangle{ 16, 512, 12, 12 }, "Draw player position", &g_drawPlayerPos);
-            GuiCheckBox(Rectangle{16, 536, 12, 12}, "Draw player body center", &g_drawPlayerCenter);
-            GuiCheckBox(Rectangle{ 16, 560, 12, 12 }, "Draw terrain shapes", &g_drawTerrainShapes);
-            GuiCheckBox(Rectangle{ 16, 584, 12, 12 }, "Draw terrain vertices", &g_drawTerrainVerts);
-            GuiCheckBox(Rectangle{ 16, 608, 12, 12 }, "Draw camera center crosshair", &g_drawCameraCrosshair);
-            GuiCheckBox(Rectangle{ 16, 632, 12, 12}, "Draw camera edge rectangle", &g_drawCameraRect);
-            GuiCheckBox(Rectangle{16, 656, 12,12}, "Draw event colliders", &g_drawEventColliders);
-            GuiCheckBox(Rectangle{16, 680, 12, 12}, "Enable shader effects", &g_drawShaderEffects);
-            GuiCheckBox(Rectangle{16, 704, 12, 12}, "Draw Player animationId", &g_drawPlayerAnimId);
-            GuiCheckBox(Rectangle{16, 728, 12, 12}, "Draw Player actionState", &g_drawPlayerActionState);
+            GuiCheckBox(Rectangle{ 16, 368, 12, 12 }, "Draw player shapes", &g_drawPlayerShapes);
+            GuiCheckBox(Rectangle{ 16, 392, 12, 12 }, "Draw player sensor status", &g_drawPlayerSensorStatus);
+            GuiCheckBox(Rectangle{ 16, 416, 12, 12 }, "Draw player position", &g_drawPlayerPos);
+            GuiCheckBox(Rectangle{16, 440, 12, 12}, "Draw player body center", &g_drawPlayerCenter);
+            GuiCheckBox(Rectangle{ 16, 464, 12, 12 }, "Draw terrain shapes", &g_drawTerrainShapes);
+            GuiCheckBox(Rectangle{ 16, 488, 12, 12 }, "Draw terrain vertices", &g_drawTerrainVerts);
+            GuiCheckBox(Rectangle{ 16, 512, 12, 12 }, "Draw camera center crosshair", &g_drawCameraCrosshair);
+            GuiCheckBox(Rectangle{ 16, 536, 12, 12}, "Draw camera edge rectangle", &g_drawCameraRect);
+            GuiCheckBox(Rectangle{16, 560, 12,12}, "Draw event colliders", &g_drawEventColliders);
+            GuiCheckBox(Rectangle{16, 584, 12, 12}, "Enable shader effects", &g_drawShaderEffects);
+            GuiCheckBox(Rectangle{16, 608, 12, 12}, "Draw Player animationId", &g_drawPlayerAnimId);
+            GuiCheckBox(Rectangle{16, 632, 12, 12}, "Draw Player actionState", &g_drawPlayerActionState);
+            GuiCheckBox(Rectangle{16, 656, 12, 12}, "Draw tile render stats", &g_drawTileRenderStats);
+            GuiComboBox(Rectangle{16, 680, 120, 16}, "Per tile;Baked chunks;Vertex batch", &g_tileRenderMode);
+            GuiCheckBox(Rectangle{16, 704, 12, 12}, "Draw streamed regions", &g_drawStreamedRegions);
+            GuiCheckBox(Rectangle{16, 728, 12, 12}, "Draw light stats", &g_drawLightStats);
+            GuiCheckBox(Rectangle{16, 752, 12, 12}, "Draw render scale", &g_drawRenderScale);
+            GuiCheckBox(Rectangle{16, 776, 12, 12}, "Draw task scheduler stats", &g_drawSchedulerStats);
         }
     }
 }
\ No newline at end of file
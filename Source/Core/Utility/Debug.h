@@ -22,6 +22,12 @@
 #include "./Enum.h"
 
 namespace RE::Core {
+    class WorldStreamer;
+    class LightManager;
+    class DynamicResolution;
+    struct renderQueueStats;
+    struct schedulerStats;
+
     // Draw all the shapes bound to a Player object for debugging
     void drawDebugBodyShapes(const Player& player);
 
@@ -51,6 +57,9 @@ namespace RE::Core {
     // Draw event colliders in the world
     void drawDebugEventColliders(const MapData& map);
 
+    // Draw the bounds and state of each streamed region, and its collision if terrain/collider drawing is on
+    void drawDebugStreamedRegions(const WorldStreamer& streamer);
+
     // Draw the current animation ID of the player
     // Must be called AFTER SceneCamera->cameraEnd()
     void drawDebugPlayerAnimId(const animationId& id);
@@ -59,6 +68,26 @@ namespace RE::Core {
     // Must be called AFTER SceneCamera->cameraEnd()
     void drawDebugPlayerAnimState(const entityActionState& state);
 
+    // Draw the visited/culled/drawn tile counts from the last map render, and what the render queue submitted
+    // Must be called AFTER SceneCamera->cameraEnd()
+    void drawDebugTileRenderStats(const renderQueueStats& queueStats);
+
+    // Draw how many lights are on screen and how they were binned
+    // Must be called AFTER SceneCamera->cameraEnd()
+    void drawDebugLightStats(const LightManager& lights);
+
+    // Draw the dynamic render scale and how much of the frame time budget is left
+    // Must be called AFTER SceneCamera->cameraEnd()
+    void drawDebugRenderScale(const DynamicResolution& resolution);
+
+    // Draw how busy the task scheduler's workers were since the last sample and what's still queued
+    // Must be called AFTER SceneCamera->cameraEnd()
+    void drawDebugSchedulerStats(const schedulerStats& stats);
+
+    // Number of global operator new calls made by the calling thread since it started, used to check hot paths
+    // on the main thread for allocations. Always 0 in release builds
+    [[nodiscard]] std::size_t getHeapAllocCount() noexcept;
+
     // Draw controls window for debugging features
     // Must be called AFTER SceneCamera->cameraEnd()
     void drawControlsWindow();
@@ -47,6 +47,7 @@ namespace RE::Core {
             case sensorType::PLAYER_FOOTPAW_SENSOR: return "PLAYER_FOOTPAW_SENSOR";
             case sensorType::MURDER_BOX: return "MURDER_BOX";
             case sensorType::CHECKPOINT: return "CHECKPOINT";
+            case sensorType::MAP_EXIT: return "MAP_EXIT";
             default: return "No such sensor type exists";
         }
     }
@@ -66,6 +67,43 @@ namespace RE::Core {
         }
     }
 
+    std::string mapLoadStageToStr(const mapLoadStage& stage) {
+        switch (stage) {
+            case mapLoadStage::STAGING: return "STAGING";
+            case mapLoadStage::UPLOADING_TEXTURES: return "UPLOADING_TEXTURES";
+            case mapLoadStage::CREATING_PHYSICS: return "CREATING_PHYSICS";
+            case mapLoadStage::DONE: return "DONE";
+            case mapLoadStage::FAILED: return "FAILED";
+            default: return "No such map load stage";
+        }
+    }
+
+    std::string regionStateToStr(const regionState& state) {
+        switch (state) {
+            case regionState::BUILDING: return "BUILDING";
+            case regionState::CREATING_PHYSICS: return "CREATING_PHYSICS";
+            case regionState::LOADED: return "LOADED";
+            default: return "No such region state";
+        }
+    }
+
+    std::string lightTypeToStr(const lightType& type) {
+        switch (type) {
+            case lightType::POINT: return "POINT";
+            case lightType::CONE: return "CONE";
+            case lightType::AREA: return "AREA";
+            default: return "No such light type";
+        }
+    }
+
+    std::string upscaleFilterToStr(const upscaleFilter& filter) {
+        switch (filter) {
+            case upscaleFilter::INTEGER: return "INTEGER";
+            case upscaleFilter::SHARP_BILINEAR: return "SHARP_BILINEAR";
+            default: return "No such upscale filter";
+        }
+    }
+
     std::string animIdToStr(const animationId& id) {
         switch (id) {
             case animationId::PLAYER_IDLE_RIGHT: return "PLAYER_IDLE_RIGHT";
@@ -39,6 +39,62 @@ namespace RE::Core {
         COUNT
     };
 
+    // Order RenderQueue submits its commands in, before depth, shader or texture
+    enum class drawPass : std::uint8_t {
+        BACKGROUND,     // Map layers drawn under entities
+        ENTITIES,
+        FOREGROUND,     // Map layers drawn over entities
+        COUNT
+    };
+
+    // How tile layers are submitted. Switchable at runtime for A/B benchmarking
+    enum class tileRenderMode : std::uint8_t {
+        PER_TILE,       // One draw per visible tile
+        BAKED,          // Tiles pre-composited into cached render texture chunks
+        BATCHED,        // Prebuilt quads submitted as one rlgl batch per tileset texture
+        COUNT
+    };
+
+    // What a compiled render pass entry draws
+    enum class mapLayerKind : std::uint8_t {
+        TILE_LAYER,
+        IMAGE_LAYER,
+        COUNT
+    };
+
+    // Where an asynchronous map load is at, in order
+    enum class mapLoadStage : std::uint8_t {
+        STAGING,            // Parsing and decoding on the worker thread
+        UPLOADING_TEXTURES, // Main thread, a few textures per frame
+        CREATING_PHYSICS,   // Main thread, a few Box2D bodies per frame
+        DONE,
+        FAILED,
+        COUNT
+    };
+
+    // Where a region of a streamed map is at, in order
+    enum class regionState : std::uint8_t {
+        BUILDING,         // Tile layers being built on a worker thread
+        CREATING_PHYSICS, // Main thread, a few Box2D bodies per frame
+        LOADED,
+        COUNT
+    };
+
+    // Shapes of light the lighting shader knows how to draw. Values are sent to the shader as is.
+    enum class lightType : std::uint8_t {
+        POINT,
+        CONE,
+        AREA,   // Axis aligned rectangle that's lit evenly inside
+        COUNT
+    };
+
+    // How the internal resolution frame is scaled up to the window
+    enum class upscaleFilter : std::uint8_t {
+        INTEGER,            // Largest whole multiple that fits, letterboxed, nearest neighbor
+        SHARP_BILINEAR,     // Fills the window, nearest neighbor inside texels and blended only at their edges
+        COUNT
+    };
+
     // Type of layer. Whether or not the layer can be drawn on top of another layer (partially transparent)
     enum class layerType : std::uint8_t {
         PRIMARY_LAYER,
@@ -75,6 +131,16 @@ namespace RE::Core {
         PLAYER_FOOTPAW_GROUND_CONTACT,
         PLAYER_DEATH_COLLIDER_CONTACT,
         PLAYER_CHECKPOINT_COLLIDER_CONTACT,
+        PLAYER_MAP_EXIT_CONTACT,
+        COUNT
+    };
+
+    // Where a TaskScheduler task may run. SHORT tasks are the pieces of a frame's own work, parallelFor()
+    // ranges and Box2D's, the only ones the main thread picks up while it waits.
+    enum class taskKind : std::uint8_t {
+        BACKGROUND,
+        SHORT,
+        MAIN_THREAD,
         COUNT
     };
 
@@ -83,6 +149,7 @@ namespace RE::Core {
         PLAYER_FOOTPAW_SENSOR,
         MURDER_BOX,
         CHECKPOINT,
+        MAP_EXIT,
         COUNT
     };
 
@@ -135,6 +202,10 @@ namespace RE::Core {
     std::string sensorToStr(const sensorType& type);
     std::string soundIdToStr(const soundId& id);
     std::string musicIdToStr(const musicId& id);
+    std::string mapLoadStageToStr(const mapLoadStage& stage);
+    std::string regionStateToStr(const regionState& state);
+    std::string lightTypeToStr(const lightType& type);
+    std::string upscaleFilterToStr(const upscaleFilter& filter);
     animationId strToAnimId(const std::string& str);
 
     template<typename E>
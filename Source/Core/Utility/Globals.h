@@ -22,14 +22,34 @@
 
 static constexpr uint16_t g_windowWidth = 1500;
 static constexpr uint16_t g_windowHeight = 800;
+constexpr float g_cameraZoom = 1.5f;                // Window pixels per world pixel
+constexpr bool g_useInternalResolution = true;      // Draw the world one texel per world pixel, then scale it up
+inline int g_upscaleFilter = 1;                     // Underlying value of Core::upscaleFilter
+constexpr double g_targetFrameTime = 1.0 / 60.0;    // Seconds per frame when the monitor's refresh rate is unknown
+constexpr bool g_limitFrameRate = true;             // Sleep off what's left of each refresh, otherwise run uncapped
+constexpr unsigned int g_taskWorkerCount = 0;       // Task scheduler threads besides the main one, 0 for spare cores
+constexpr double g_mainThreadTaskBudget = 0.002;    // Seconds per frame spent on tasks queued for the main thread
+
+constexpr bool g_useDynamicResolution = true;       // Trade internal resolution for frame time, needs the above
+constexpr float g_minRenderScale = 0.5f;            // Smallest fraction of the internal resolution drawn
+constexpr float g_renderScaleStep = 0.1f;
+constexpr std::size_t g_frameTimeWindow = 60;       // Frames averaged before the render scale can change again
+constexpr double g_renderScaleDownHeadroom = 0.05;  // Scale drops when less of the frame than this is left over
+constexpr double g_renderScaleUpHeadroom = 0.35;    // and rises when more than this is
+
 // Replace this with a serialized config later...
 inline std::string g_playerSpritePath = "../assets/Player assets/Walksprites_v5.png";
 inline std::string g_playerAnimPath = "../assets/Player assets/player_anims.toml";
 
 constexpr double g_pi = 3.14159265359;
 
-constexpr float g_worldStep = 1.0f / 60.0f;
+constexpr float g_worldStep = 1.0f / 60.0f;         // Seconds simulated per world step, whatever the frame rate
 constexpr std::uint8_t g_subStep = 4;
+constexpr std::uint8_t g_maxWorldSteps = 5;         // Steps one frame can catch up on, the rest of a stall is dropped
+
+constexpr bool g_simplifyCollision = true;          // Simplify Tiled collision polylines as they're loaded
+constexpr float g_collisionSimplifyTolerance = 0.01f; // Meters a dropped vertex may sit off the simplified line
+constexpr float g_collisionSimplifyAngle = 0.1745f; // Radians a segment may turn from it, about 10 degrees
 
 constexpr float g_playerWalkMultiplier = 0.50f;
 constexpr float g_playerJumpMultiplier = 16.0f;
@@ -56,6 +76,12 @@ inline bool g_drawEventColliders = false;
 inline bool g_drawShaderEffects = true;
 inline bool g_drawPlayerAnimId = false;
 inline bool g_drawPlayerActionState = false;
+inline bool g_drawTileRenderStats = false;
+inline bool g_drawStreamedRegions = false;
+inline bool g_drawLightStats = false;
+inline bool g_drawRenderScale = false;
+inline bool g_drawSchedulerStats = false;
+inline int g_tileRenderMode = 2; // Underlying value of Core::tileRenderMode, int for raygui
 
 constexpr Color g_debugBodyColor{0, 0, 255, 255};
 constexpr Color g_debugCollisionColor{255, 0, 0, 255};
@@ -68,6 +94,25 @@ constexpr Vector2 g_debugTextPos = {10.0f, 10.0f};
 
 constexpr uint8_t g_ppm = 100; // 100 px/meter
 
+constexpr uint16_t g_tileChunkSize = 16; // Tiles per chunk edge, used for render culling
+constexpr std::size_t g_bakedChunkBudgetBytes = 64 * 1024 * 1024; // VRAM allowed for baked tile chunks
+
+constexpr int g_atlasPageSize = 4096;      // Width and height of each texture atlas page
+constexpr int g_atlasMaxImageSize = 2048;  // Images larger than this on either axis keep their own texture
+constexpr int g_atlasPadding = 2;          // Empty pixels between packed images
+
+constexpr double g_mapLoadFrameBudget = 0.006; // Seconds per frame the main thread spends finishing async map loads
+
+constexpr int g_streamRegionSize = 64;            // Tiles per region edge in streamed maps
+constexpr int g_streamLoadRadius = 1;             // Regions around the camera that are kept loaded
+constexpr int g_streamUnloadRadius = 2;           // Regions further out than this are destroyed
+constexpr std::size_t g_streamMaxBuilding = 4;    // Regions being built on worker threads at once
+constexpr double g_streamFrameBudget = 0.002;     // Seconds per frame spent creating streamed physics
+
+constexpr float g_mapPrefetchDistance = 640.0f;     // Pixels from a map exit at which the next map starts loading
+constexpr float g_mapPrefetchHysteresis = 192.0f;   // Pixels closer another exit has to be to replace the prefetch
+constexpr double g_mapPrefetchFrameBudget = 0.002;  // Seconds per frame spent finishing a prefetched map
+
 inline std::random_device g_randomDevice;
 inline std::mt19937 g_randomGenerator(g_randomDevice());
 
@@ -81,6 +126,28 @@ constexpr float g_buttonWidthScaleFactor = 0.97f;
 constexpr float g_buttonHeightScaleFactor = 0.98f;
 constexpr float g_buttonTextScaleFactor = 0.30f;
 
+constexpr Color g_defaultLightColor{255, 214, 170, 255};   // Lights placed in Tiled without a color
+constexpr float g_defaultLightRadius = 300.0f;              // World pixels
+constexpr float g_defaultConeAngle = 60.0f;                 // Degrees
+constexpr float g_defaultConeSoftness = 0.2f;
+
+constexpr std::size_t g_maxLights = 1024;           // Lights on screen at once, the rest are dropped
+constexpr int g_lightTileSize = 32;                 // Screen pixels per edge of a light binning tile
+constexpr std::size_t g_maxLightsPerTile = 32;      // Caps the shader's per-fragment loop
+constexpr int g_lightIndexTextureWidth = 1024;
+
+constexpr int g_lightingDownscale = 2;              // Lighting runs at the screen size over this, 1 lights every pixel
+
+constexpr int g_shadowAtlasSize = 2048;             // Pixels per edge of the shadow mask atlas
+constexpr int g_shadowCellSize = 128;               // Pixels per edge of one light's mask
+constexpr float g_shadowGridCellSize = 256.0f;      // World pixels per edge of a shadow segment grid cell
+constexpr float g_shadowMoveTolerance = 0.5f;       // World pixels a light can move before its mask is redrawn
+
+constexpr Color g_flashlightColor{122, 122, 122, 255};
+constexpr float g_flashlightRadius = 800.0f;        // Window pixels, so it doesn't change with zoom
+constexpr float g_flashlightConeAngle = 1.0472f;    // Radians
+constexpr float g_flashlightSoftness = 0.2f;
+
 constexpr float g_beamOffsetXRight = 123.5f;
 constexpr float g_beamOffsetXLeft = 40.0f;
 constexpr float g_beamOffsetY = 110.0f;
@@ -0,0 +1,97 @@
+//
+// Author: DirgeWuff
+// Created on: 10/18/26
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Module purpose/description:
+//
+// Function definitions for MappedFile.h
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include "MappedFile.h"
+
+namespace RE::Core {
+#ifdef _WIN32
+    MappedFile::MappedFile(const fs::path& path) {
+        m_fileHandle = CreateFileW(
+            path.wstring().c_str(),
+            GENERIC_READ,
+            FILE_SHARE_READ,
+            nullptr,
+            OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+            nullptr);
+
+        if (m_fileHandle == INVALID_HANDLE_VALUE) {
+            m_fileHandle = nullptr;
+            return;
+        }
+
+        LARGE_INTEGER size{};
+        if (!GetFileSizeEx(m_fileHandle, &size) || size.QuadPart == 0) return;
+
+        m_mappingHandle = CreateFileMappingW(m_fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!m_mappingHandle) return;
+
+        const void* view = MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0);
+        if (!view) return;
+
+        m_data = static_cast<const std::byte*>(view);
+        m_size = static_cast<std::size_t>(size.QuadPart);
+    }
+
+    MappedFile::~MappedFile() {
+        if (m_data) UnmapViewOfFile(m_data);
+        if (m_mappingHandle) CloseHandle(m_mappingHandle);
+        if (m_fileHandle) CloseHandle(m_fileHandle);
+    }
+#else
+    MappedFile::MappedFile(const fs::path& path) {
+        m_fileDescriptor = open(path.c_str(), O_RDONLY);
+        if (m_fileDescriptor < 0) return;
+
+        struct stat fileStats{};
+        if (fstat(m_fileDescriptor, &fileStats) != 0 || fileStats.st_size == 0) return;
+
+        void* view = mmap(nullptr, static_cast<std::size_t>(fileStats.st_size), PROT_READ, MAP_PRIVATE, m_fileDescriptor, 0);
+        if (view == MAP_FAILED) return;
+
+        // The whole file is read front to back during a load
+        madvise(view, static_cast<std::size_t>(fileStats.st_size), MADV_SEQUENTIAL);
+
+        m_data = static_cast<const std::byte*>(view);
+        m_size = static_cast<std::size_t>(fileStats.st_size);
+    }
+
+    MappedFile::~MappedFile() {
+        if (m_data) munmap(const_cast<std::byte*>(m_data), m_size);
+        if (m_fileDescriptor >= 0) close(m_fileDescriptor);
+    }
+#endif
+
+    [[nodiscard]] bool MappedFile::isValid() const noexcept {
+        return m_data != nullptr;
+    }
+
+    [[nodiscard]] const std::byte* MappedFile::getData() const noexcept {
+        return m_data;
+    }
+
+    [[nodiscard]] std::size_t MappedFile::getSize() const noexcept {
+        return m_size;
+    }
+}
@@ -0,0 +1,51 @@
+//
+// Author: DirgeWuff
+// Created on: 10/18/26
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Module purpose/description:
+//
+// Read-only memory mapped file. Used to load precompiled data straight out
+// of the page cache without reading or parsing it first. Deliberately has
+// no raylib dependency, windows.h and raylib.h can't share a translation unit.
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+namespace RE::Core {
+    class MappedFile {
+        const std::byte* m_data{};
+        std::size_t m_size{};
+    #ifdef _WIN32
+        void* m_fileHandle{};
+        void* m_mappingHandle{};
+    #else
+        int m_fileDescriptor = -1;
+    #endif
+    public:
+        MappedFile() = default;
+        explicit MappedFile(const fs::path& path);
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile(MappedFile&&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile& operator=(MappedFile&&) = delete;
+
+        // False if the file couldn't be opened or mapped, or is empty
+        [[nodiscard]] bool isValid() const noexcept;
+        [[nodiscard]] const std::byte* getData() const noexcept;
+        [[nodiscard]] std::size_t getSize() const noexcept;
+    };
+}
+
+#endif //MAPPEDFILE_H
@@ -0,0 +1,57 @@
+//
+// Author: DirgeWuff
+// Created on: 10/18/26
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Module purpose/description:
+//
+// Function definitions for MemoryStats.h
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+    #include <psapi.h>
+#elif defined(__APPLE__)
+    #include <mach/mach.h>
+#else
+    #include <fstream>
+    #include <unistd.h>
+#endif
+
+#include "MemoryStats.h"
+
+namespace RE::Core {
+    [[nodiscard]] std::size_t getResidentMemoryBytes() {
+    #ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS counters{};
+        if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+
+        return counters.WorkingSetSize;
+    #elif defined(__APPLE__)
+        mach_task_basic_info info{};
+        mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+
+        if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) !=
+            KERN_SUCCESS)
+        {
+            return 0;
+        }
+
+        return info.resident_size;
+    #else
+        // Second field is resident pages
+        std::ifstream statm("/proc/self/statm");
+        std::size_t totalPages = 0;
+        std::size_t residentPages = 0;
+
+        if (!(statm >> totalPages >> residentPages)) return 0;
+
+        return residentPages * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    #endif
+    }
+}
@@ -0,0 +1,25 @@
+//
+// Author: DirgeWuff
+// Created on: 10/18/26
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Module purpose/description:
+//
+// Process memory queries for load time reports. Like MappedFile this has no
+// raylib dependency, since the Windows version needs windows.h.
+
+#ifndef MEMORYSTATS_H
+#define MEMORYSTATS_H
+
+#include <cstddef>
+
+namespace RE::Core {
+    // Resident set size of the whole process in bytes, or 0 if the platform won't say
+    [[nodiscard]] std::size_t getResidentMemoryBytes();
+}
+
+#endif //MEMORYSTATS_H
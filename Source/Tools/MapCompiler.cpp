@@ -0,0 +1,178 @@
+//
+// Author: DirgeWuff
+// Created on: 10/18/26
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Module purpose/description:
+//
+// Entry point for redeye-mapc, the headless map compiler. Validates Tiled maps
+// and compiles them to .rmap files using the same code the game loads maps
+// with, so a map that compiles is a map that loads. Never opens a window.
+//
+// Usage: redeye-mapc [-j jobs] [-o outputDir] [--no-atlas] [--no-simplify] <map.tmj | directory>...
+// Directories are searched recursively for .tmj files. With -o, maps found in
+// a directory keep their path relative to it. Maps are compiled in parallel,
+// one per worker thread. Exits with 1 if any map failed.
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "raylib.h"
+#include "../Core/Serialization/BinaryMap.h"
+
+namespace fs = std::filesystem;
+
+static void printUsage() {
+    std::cerr << "Usage: redeye-mapc [-j jobs] [-o outputDir] [--no-atlas] [--no-simplify] "
+                 "<map.tmj | directory>...\n";
+}
+
+struct mapInput {
+    fs::path path;
+    fs::path outputName;    // Relative to -o, mirrors where the map was found under its input directory
+};
+
+static void collectMaps(const fs::path& input, std::vector<mapInput>& maps) {
+    std::error_code ec;
+
+    if (fs::is_directory(input, ec)) {
+        for (const auto& entry : fs::recursive_directory_iterator(input, ec)) {
+            if (entry.is_regular_file() && entry.path().extension() == ".tmj") {
+                maps.push_back({entry.path(), entry.path().lexically_relative(input)});
+            }
+        }
+    }
+    else {
+        maps.push_back({input, input.filename()});
+    }
+}
+
+int main(const int argc, char** argv) {
+    RE::Core::rmapWriteOptions options = {true, true};
+    unsigned int jobCount = std::max(1u, std::thread::hardware_concurrency());
+    fs::path outputDir;
+    std::vector<mapInput> maps;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+
+        if (arg == "-j" && i + 1 < argc) {
+            jobCount = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (arg == "-o" && i + 1 < argc) {
+            outputDir = argv[++i];
+        }
+        else if (arg == "--no-atlas") {
+            options.packAtlas = false;
+        }
+        else if (arg == "--no-simplify") {
+            options.simplifyCollision = false;
+        }
+        else if (arg == "-h" || arg == "--help" || arg.starts_with("-")) {
+            printUsage();
+            return arg.starts_with("-h") || arg == "--help" ? 0 : 1;
+        }
+        else {
+            collectMaps(arg, maps);
+        }
+    }
+
+    if (maps.empty()) {
+        printUsage();
+        return 1;
+    }
+
+    std::vector<fs::path> outputPaths;
+    outputPaths.reserve(maps.size());
+
+    for (const auto& map : maps) {
+        fs::path outputPath = outputDir.empty() ? map.path : outputDir / map.outputName;
+        outputPath.replace_extension(".rmap");
+        outputPaths.push_back(outputPath.lexically_normal());
+    }
+
+    // Two workers writing the same .rmap and atlas would leave whichever finished last, so this is
+    // caught before any of them start
+    std::map<fs::path, std::size_t> outputOwners;
+    bool hasCollision = false;
+
+    for (std::size_t i = 0; i < maps.size(); i++) {
+        const auto [owner, isNew] = outputOwners.try_emplace(outputPaths[i], i);
+        if (isNew) continue;
+
+        std::cerr << maps[owner->second].path.string() << " and " << maps[i].path.string()
+                  << " would both compile to " << outputPaths[i].string() << "\n";
+        hasCollision = true;
+    }
+
+    if (hasCollision) return 1;
+
+    for (const auto& outputPath : outputPaths) {
+        if (outputDir.empty() || !outputPath.has_parent_path()) continue;
+
+        std::error_code ec;
+        fs::create_directories(outputPath.parent_path(), ec);
+
+        if (ec) {
+            std::cerr << "Unable to create output directory " << outputPath.parent_path().string() << ": "
+                      << ec.message() << "\n";
+            return 1;
+        }
+    }
+
+    // Image loading is the only thing raylib gets used for here, only its warnings are worth seeing
+    SetTraceLogLevel(LOG_WARNING);
+
+    std::atomic<std::size_t> nextMap = 0;
+    std::atomic<std::size_t> failedCount = 0;
+    std::mutex outputMutex;
+
+    // Maps share nothing, so each worker just takes the next one until there are none left
+    const auto worker = [&]() {
+        std::string error;
+
+        for (std::size_t i = nextMap++; i < maps.size(); i = nextMap++) {
+            const fs::path& outputPath = outputPaths[i];
+
+            error.clear();
+            const bool isCompiled = RE::Core::compileBinaryMap(maps[i].path, outputPath, options, error);
+
+            const std::lock_guard lock(outputMutex);
+
+            if (isCompiled) {
+                std::cout << "Compiled " << maps[i].path.string() << " -> " << outputPath.string() << "\n";
+            }
+            else {
+                std::cerr << "Failed " << maps[i].path.string() << ":\n" << error << "\n";
+                ++failedCount;
+            }
+        }
+    };
+
+    jobCount = std::min(jobCount, static_cast<unsigned int>(maps.size()));
+    std::vector<std::thread> workers;
+    workers.reserve(jobCount);
+
+    for (unsigned int i = 0; i < jobCount; i++) {
+        workers.emplace_back(worker);
+    }
+
+    for (auto& thread : workers) {
+        thread.join();
+    }
+
+    std::cout << maps.size() - failedCount << " of " << maps.size() << " maps compiled\n";
+
+    return failedCount == 0 ? 0 : 1;
+}